@@ -0,0 +1,166 @@
+/*
+ * This template creates a fuzz target for the dense and roaring bitsets generated by
+ * bitset.template.c. Three sets of each kind are compared with bool arrays over the values [0,
+ * DOMAIN). Single values, runs of values and run optimization of the first two sets make all roaring
+ * container kinds appear. The set operations write to any of the three sets, including in place
+ * into an operand, and their results are compared in the same way.
+ *
+ * There are three template parameters: NAME, TYPE and DOMAIN. The bitsets must be generated into
+ * bitset_NAME.h.
+ *
+ * The typedef below is just to make the template file syntactically correct c. It is a cgen comment
+ * and will be ignored.
+ */
+
+typedef int TYPE;
+
+// cgen header
+
+#include <stddef.h>
+#include <stdint.h>
+
+int fuzz_bitset_NAME(const uint8_t *data, size_t size);
+// cgen source
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "fuzz.h"
+#include "bitset_NAME.h"
+
+static void fuzz_bitset_NAME_check(const struct bitset_NAME *dense, const struct roaring_NAME *roaring, const bool *ref)
+{
+	struct bitset_iter_NAME dense_iter;
+	struct roaring_iter_NAME roaring_iter;
+	bitset_NAME_iter_init(&dense_iter, dense);
+	roaring_NAME_iter_init(&roaring_iter, roaring);
+	size_t rank = 0;
+	TYPE value;
+
+	for (size_t v = 0; v < DOMAIN; v++) {
+		assert(bitset_NAME_contains(dense, (TYPE) v) == ref[v]);
+		assert(roaring_NAME_contains(roaring, (TYPE) v) == ref[v]);
+		if (!ref[v]) continue;
+		assert(bitset_NAME_iter_next(&dense_iter, &value) && (size_t) value == v);
+		assert(roaring_NAME_iter_next(&roaring_iter, &value) && (size_t) value == v);
+		if (rank % 61 == 0) {
+			assert(bitset_NAME_select(dense, rank, &value) && (size_t) value == v);
+			assert(roaring_NAME_select(roaring, rank, &value) && (size_t) value == v);
+			assert(bitset_NAME_rank(dense, (TYPE) v) == rank + 1);
+			assert(roaring_NAME_rank(roaring, (TYPE) v) == rank + 1);
+		}
+		rank++;
+	}
+	assert(!bitset_NAME_iter_next(&dense_iter, &value));
+	assert(!roaring_NAME_iter_next(&roaring_iter, &value));
+	assert(bitset_NAME_cardinality(dense) == rank);
+	assert(roaring_NAME_cardinality(roaring) == rank);
+	assert(!bitset_NAME_select(dense, rank, &value));
+	assert(!roaring_NAME_select(roaring, rank, &value));
+}
+
+int fuzz_bitset_NAME(const uint8_t *data, size_t size)
+{
+	struct fuzz_input in = {data, size};
+	struct bitset_NAME dense[3];
+	struct roaring_NAME roaring[3];
+	bool *ref[3];
+	bool *expected = calloc(DOMAIN, sizeof(bool));
+	for (int s = 0; s < 3; s++) {
+		bitset_NAME_init(&dense[s]);
+		roaring_NAME_init(&roaring[s]);
+		ref[s] = calloc(DOMAIN, sizeof(bool));
+	}
+
+	while (in.size > 0) {
+		uint32_t op = fuzz_next(&in);
+		size_t v = fuzz_next(&in) % DOMAIN;
+		int s = (int) (op / 8 % 2);
+
+		switch (op % 8) {
+		case 0:
+			assert(bitset_NAME_add(&dense[s], (TYPE) v) == ref[s][v]);
+			assert(roaring_NAME_add(&roaring[s], (TYPE) v) == ref[s][v]);
+			ref[s][v] = true;
+			break;
+		case 1:
+			assert(bitset_NAME_remove(&dense[s], (TYPE) v) == ref[s][v]);
+			assert(roaring_NAME_remove(&roaring[s], (TYPE) v) == ref[s][v]);
+			ref[s][v] = false;
+			break;
+		case 2:
+		case 3: {
+			/* A run of adds or removes, long enough to turn array containers into bitmaps */
+			size_t end = v + fuzz_next(&in) % 6000;
+			if (end > DOMAIN) end = DOMAIN;
+			for (; v < end; v++) {
+				if (op % 8 == 2) {
+					assert(bitset_NAME_add(&dense[s], (TYPE) v) == ref[s][v]);
+					assert(roaring_NAME_add(&roaring[s], (TYPE) v) == ref[s][v]);
+				} else {
+					assert(bitset_NAME_remove(&dense[s], (TYPE) v) == ref[s][v]);
+					assert(roaring_NAME_remove(&roaring[s], (TYPE) v) == ref[s][v]);
+				}
+				ref[s][v] = op % 8 == 2;
+			}
+			break;
+		}
+		case 4:
+			roaring_NAME_run_optimize(&roaring[s]);
+			break;
+		case 5:
+			assert(bitset_NAME_contains(&dense[s], (TYPE) v) == ref[s][v]);
+			assert(roaring_NAME_contains(&roaring[s], (TYPE) v) == ref[s][v]);
+			bitset_NAME_set_simd_level((enum bitset_NAME_simd) (op / 16 % 3));
+			break;
+		case 6: {
+			/* dst = a op b for both kinds, where dst is a, b or a third set. a and b may be the
+			 * same set. The comparison is over the whole domain, so it is done for a few ops only.
+			 */
+			if (op / 16 % 16 != 0) break;
+			int a = s, b = (int) (op / 256 % 2);
+			int destinations[3] = {2, a, b};
+			int d = destinations[op / 512 % 3];
+			int kind = (int) (op / 1536 % 4);
+			for (size_t u = 0; u < DOMAIN; u++) {
+				bool x = ref[a][u], y = ref[b][u];
+				expected[u] = kind == 0 ? x && y : kind == 1 ? x || y : kind == 2 ? x != y : x && !y;
+			}
+			switch (kind) {
+			case 0:
+				assert(bitset_NAME_and(&dense[d], &dense[a], &dense[b]) == &dense[d]);
+				assert(roaring_NAME_and(&roaring[d], &roaring[a], &roaring[b]) == &roaring[d]);
+				break;
+			case 1:
+				assert(bitset_NAME_or(&dense[d], &dense[a], &dense[b]) == &dense[d]);
+				assert(roaring_NAME_or(&roaring[d], &roaring[a], &roaring[b]) == &roaring[d]);
+				break;
+			case 2:
+				assert(bitset_NAME_xor(&dense[d], &dense[a], &dense[b]) == &dense[d]);
+				assert(roaring_NAME_xor(&roaring[d], &roaring[a], &roaring[b]) == &roaring[d]);
+				break;
+			case 3:
+				assert(bitset_NAME_andnot(&dense[d], &dense[a], &dense[b]) == &dense[d]);
+				assert(roaring_NAME_andnot(&roaring[d], &roaring[a], &roaring[b]) == &roaring[d]);
+				break;
+			}
+			bool *swap = ref[d];
+			ref[d] = expected;
+			expected = swap;
+			fuzz_bitset_NAME_check(&dense[d], &roaring[d], ref[d]);
+			break;
+		}
+		case 7:
+			if (op / 8 % 16 == 0) fuzz_bitset_NAME_check(&dense[s], &roaring[s], ref[s]);
+			break;
+		}
+	}
+	for (int s = 0; s < 3; s++) {
+		fuzz_bitset_NAME_check(&dense[s], &roaring[s], ref[s]);
+		bitset_NAME_free(&dense[s]);
+		roaring_NAME_free(&roaring[s]);
+		free(ref[s]);
+	}
+	free(expected);
+	return 0;
+}
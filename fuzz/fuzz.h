@@ -0,0 +1,89 @@
+/*
+ * Shared definitions for the generated fuzz targets.
+ *
+ * A fuzz target is a function that reads a sequence of operations from a byte string, applies them
+ * to a generated container and to a simple reference model, and asserts that the two agree. The
+ * same targets are driven by fuzz_runner with random bytes and by libFuzzer.
+ *
+ * This header is also force included in the generated container sources so that they see the
+ * element types defined here.
+ */
+
+#ifndef FUZZ_H
+#define FUZZ_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+struct fuzz_target {
+	const char *name;
+	int (*run)(const uint8_t *data, size_t size);
+};
+
+extern const struct fuzz_target fuzz_targets[];
+extern const size_t fuzz_ntargets;
+
+int fuzz_one_input(const uint8_t *data, size_t size);
+
+/* The remaining input of a fuzz target */
+struct fuzz_input {
+	const uint8_t *data;
+	size_t size;
+};
+
+/* The next four bytes of the input as an integer. Bytes past the end of the input read as zero. */
+static inline uint32_t fuzz_next(struct fuzz_input *in)
+{
+	uint32_t bits = 0;
+	for (int i = 0; i < 4 && in->size > 0; i++) {
+		bits |= (uint32_t) in->data[0] << (8 * i);
+		in->data++;
+		in->size--;
+	}
+	return bits;
+}
+
+/* A struct with padding and mixed alignment, used as an element type */
+struct point {
+	double x;
+	int y;
+	char tag;
+};
+
+/* Element values are built from 32 random bits. Floating point values are multiples of 1/4 so that
+ * sums of them are exact.
+ */
+
+static inline char fuzz_char(uint32_t bits) { return (char) ((int) (bits % 101) - 50); }
+static inline int fuzz_int(uint32_t bits) { return (int) (bits % 2001) - 1000; }
+static inline long fuzz_long(uint32_t bits) { return (long) (bits % 200001) - 100000; }
+static inline unsigned fuzz_unsigned(uint32_t bits) { return bits; }
+static inline float fuzz_float(uint32_t bits) { return (float) ((int) (bits % 2001) - 1000) / 4; }
+static inline double fuzz_double(uint32_t bits) { return (double) ((int) (bits % 2001) - 1000) / 4; }
+
+static inline struct point fuzz_point(uint32_t bits)
+{
+	struct point p = {(double) (bits % 1000) / 8, (int) (bits >> 10), (char) (bits >> 24)};
+	return p;
+}
+
+static inline bool fuzz_char_equals(char a, char b) { return a == b; }
+static inline bool fuzz_int_equals(int a, int b) { return a == b; }
+static inline bool fuzz_long_equals(long a, long b) { return a == b; }
+static inline bool fuzz_double_equals(double a, double b) { return a == b; }
+static inline bool fuzz_point_equals(struct point a, struct point b) { return a.x == b.x && a.y == b.y && a.tag == b.tag; }
+
+/* Store keys are built from an index in [0, KEYS) such that the key order is the index order. */
+
+static inline char fuzz_char_key(size_t index) { return (char) ((int) index - 50); }
+static inline int fuzz_int_key(size_t index) { return 7 * (int) index - 1000; }
+static inline long fuzz_long_key(size_t index) { return 1000003L * (long) index; }
+static inline double fuzz_double_key(size_t index) { return (double) index / 2 - 100; }
+
+static inline int fuzz_char_compare(char a, char b) { return (a > b) - (a < b); }
+static inline int fuzz_int_compare(int a, int b) { return (a > b) - (a < b); }
+static inline int fuzz_long_compare(long a, long b) { return (a > b) - (a < b); }
+static inline int fuzz_double_compare(double a, double b) { return (a > b) - (a < b); }
+
+#endif
@@ -0,0 +1,172 @@
+/*
+ * fuzz_runner runs the fuzz targets on random inputs. A run is one target on the input generated
+ * from one seed. The input lengths cycle through INPUT_SIZES so that both short and long sequences
+ * of operations are tested.
+ *
+ * The runs are sharded over worker processes, by default one per core. Every run is a process of its
+ * own, so an assertion failure or a sanitizer error in one run is reported with the target and the
+ * seed that reproduce it, and the remaining runs continue.
+ *
+ * Usage: fuzz_runner [-j jobs] [-n runs per target] [-s first seed] [-t target] [-f file] [-l]
+ *
+ *   -j  the number of worker processes.
+ *   -n  the number of runs of each target.
+ *   -s  the seed of the first run.
+ *   -t  only the target with this name is run.
+ *   -f  the content of the file is run instead of random inputs, with the target given by -t or by
+ *       the first byte as in libFuzzer. This reproduces a crash found by libFuzzer.
+ *   -l  the targets are listed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "fuzz.h"
+
+static const size_t INPUT_SIZES[] = {64, 1024, 16384, 65536};
+
+/* splitmix64 */
+static uint64_t next_random(uint64_t *state)
+{
+	uint64_t z = (*state += 0x9e3779b97f4a7c15);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+	return z ^ (z >> 31);
+}
+
+static void run(const struct fuzz_target *target, uint64_t seed)
+{
+	size_t size = INPUT_SIZES[seed % (sizeof INPUT_SIZES / sizeof INPUT_SIZES[0])];
+	uint8_t *data = malloc(size);
+	uint64_t state = seed;
+	for (size_t i = 0; i < size; i++) {
+		data[i] = (uint8_t) next_random(&state);
+	}
+	target->run(data, size);
+	free(data);
+}
+
+static int run_file(const char *path, const struct fuzz_target *target)
+{
+	FILE *file = fopen(path, "rb");
+	if (file == NULL) {
+		fprintf(stderr, "The file %s could not be opened\n", path);
+		return 1;
+	}
+	size_t size = 0, capacity = 4096;
+	uint8_t *data = malloc(capacity);
+	size_t n;
+	while ((n = fread(data + size, 1, capacity - size, file)) > 0) {
+		size += n;
+		if (size == capacity) data = realloc(data, capacity *= 2);
+	}
+	fclose(file);
+
+	if (target != NULL) {
+		target->run(data, size);
+	} else {
+		fuzz_one_input(data, size);
+	}
+	free(data);
+	printf("%s ran succesfully\n", path);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+	size_t runs = 100;
+	uint64_t first_seed = 1;
+	const char *target_name = NULL;
+	const char *file = NULL;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "j:n:s:t:f:l")) != -1) {
+		switch (opt) {
+		case 'j': jobs = atol(optarg); break;
+		case 'n': runs = strtoul(optarg, NULL, 10); break;
+		case 's': first_seed = strtoull(optarg, NULL, 10); break;
+		case 't': target_name = optarg; break;
+		case 'f': file = optarg; break;
+		case 'l':
+			for (size_t t = 0; t < fuzz_ntargets; t++) printf("%s\n", fuzz_targets[t].name);
+			return 0;
+		default:
+			fprintf(stderr, "Usage: %s [-j jobs] [-n runs per target] [-s first seed] [-t target] [-f file] [-l]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (jobs < 1) jobs = 1;
+
+	const struct fuzz_target *targets = fuzz_targets;
+	size_t ntargets = fuzz_ntargets;
+	if (target_name != NULL) {
+		ntargets = 0;
+		for (size_t t = 0; t < fuzz_ntargets; t++) {
+			if (strcmp(fuzz_targets[t].name, target_name) != 0) continue;
+			targets = fuzz_targets + t;
+			ntargets = 1;
+		}
+		if (ntargets == 0) {
+			fprintf(stderr, "There is no target %s\n", target_name);
+			return 1;
+		}
+	}
+
+	if (file != NULL) return run_file(file, target_name != NULL ? targets : NULL);
+
+	/* Run i is target i % ntargets with seed first_seed + i / ntargets, so that the targets are
+	 * interleaved and the workers stay busy until the end.
+	 */
+	size_t total = ntargets * runs;
+	pid_t *pids = calloc((size_t) jobs, sizeof(pid_t));
+	size_t *items = calloc((size_t) jobs, sizeof(size_t));
+	size_t next = 0, running = 0, failures = 0;
+
+	while (next < total || running > 0) {
+		for (long w = 0; w < jobs && next < total; w++) {
+			if (pids[w] != 0) continue;
+			pid_t pid = fork();
+			if (pid < 0) {
+				perror("fork");
+				return 1;
+			}
+			if (pid == 0) {
+				run(&targets[next % ntargets], first_seed + next / ntargets);
+				_exit(0);
+			}
+			pids[w] = pid;
+			items[w] = next++;
+			running++;
+		}
+
+		int status;
+		pid_t pid = wait(&status);
+		if (pid < 0) {
+			perror("wait");
+			return 1;
+		}
+		for (long w = 0; w < jobs; w++) {
+			if (pids[w] != pid) continue;
+			if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+				const struct fuzz_target *target = &targets[items[w] % ntargets];
+				uint64_t seed = first_seed + items[w] / ntargets;
+				fprintf(stderr, "FAILED: %s seed %llu, rerun with %s -t %s -s %llu -n 1\n", target->name,
+					(unsigned long long) seed, argv[0], target->name, (unsigned long long) seed);
+				failures++;
+			}
+			pids[w] = 0;
+			running--;
+		}
+	}
+
+	printf("%zu runs of %zu targets on %ld workers, %zu failures\n", total, ntargets, jobs, failures);
+	free(pids);
+	free(items);
+	return failures > 0;
+}
@@ -0,0 +1,13 @@
+#include "fuzz.h"
+#include "targets.h"
+
+const size_t fuzz_ntargets = sizeof fuzz_targets / sizeof fuzz_targets[0];
+
+/* The first byte of the input selects the target and the rest is the input of the target. This is
+ * the entry point for libFuzzer which sees all targets as one.
+ */
+int fuzz_one_input(const uint8_t *data, size_t size)
+{
+	if (size == 0) return 0;
+	return fuzz_targets[data[0] % fuzz_ntargets].run(data + 1, size - 1);
+}
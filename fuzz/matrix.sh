@@ -0,0 +1,105 @@
+#!/bin/sh
+#
+# The instantiation matrix of the fuzz harness. Each line at the bottom of this file generates a
+# container with cgen together with a fuzz target for it. The instantiations differ in key and value
+# types, element sizes and struct layouts, and in the number of possible keys or values. The conf
+# files, the generated sources and the table of targets, targets.h, are written to the directory gen.
+#
+# Usage: sh matrix.sh path-to-cgen
+
+set -e
+
+cgen=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+templates=../../templates
+
+mkdir -p gen
+cd gen
+rm -f *.conf *.h *.c
+: > targets.list
+
+# generate template header key-value...
+generate() {
+	conf=${2%.h}.conf
+	{
+		echo "template = $1"
+		echo "header = $2"
+		echo "source = ${2%.h}.c"
+		echo
+		shift 2
+		for key_value in "$@"; do echo "$key_value"; done
+	} > "$conf"
+	"$cgen" "$conf"
+}
+
+# target kind name
+target() {
+	echo "$1_$2" >> targets.list
+}
+
+# vector name type value-of equals
+vector() {
+	generate $templates/vector/vector.template.c vector_$1.h "NAME = $1" "TYPE = $2"
+	generate ../vector_fuzz.template.c fuzz_vector_$1.h "NAME = $1" "TYPE = $2" "VALUE_OF = $3" "EQUALS = $4"
+	target vector $1
+}
+
+# vector_ops name type value-of
+vector_ops() {
+	generate $templates/vector/vector.template.c vector_$1.h "NAME = $1" "TYPE = $2"
+	generate $templates/vector/vector_ops.template.c vector_ops_$1.h "NAME = $1" "TYPE = $2" "VECTOR_HEADER = vector_$1.h"
+	generate ../vector_ops_fuzz.template.c fuzz_vector_ops_$1.h "NAME = $1" "TYPE = $2" "VALUE_OF = $3"
+	target vector_ops $1
+}
+
+# store name key-type value-type key-of compare value-of equals keys
+store() {
+	generate $templates/linear_key_value_store/store.template.c store_$1.h "NAME = $1" "KEY_TYPE = $2" "VALUE_TYPE = $3"
+	generate ../store_fuzz.template.c fuzz_store_$1.h "NAME = $1" "KEY_TYPE = $2" "VALUE_TYPE = $3" \
+		"KEY_OF = $4" "COMPARE = $5" "VALUE_OF = $6" "EQUALS = $7" "KEYS = $8"
+	target store $1
+}
+
+# slot_map name type value-of equals
+slot_map() {
+	generate $templates/slot_map/slot_map.template.c slot_map_$1.h "NAME = $1" "TYPE = $2"
+	generate ../slot_map_fuzz.template.c fuzz_slot_map_$1.h "NAME = $1" "TYPE = $2" "VALUE_OF = $3" "EQUALS = $4"
+	target slot_map $1
+}
+
+# bitset name type domain
+bitset() {
+	generate $templates/bitset/bitset.template.c bitset_$1.h "NAME = $1" "TYPE = $2"
+	generate ../bitset_fuzz.template.c fuzz_bitset_$1.h "NAME = $1" "TYPE = $2" "DOMAIN = $3"
+	target bitset $1
+}
+
+vector point "struct point" fuzz_point fuzz_point_equals
+
+vector_ops char char fuzz_char
+vector_ops int int fuzz_int
+vector_ops long long fuzz_long
+vector_ops unsigned unsigned fuzz_unsigned
+vector_ops float float fuzz_float
+vector_ops double double fuzz_double
+
+store int_int int int fuzz_int_key fuzz_int_compare fuzz_int fuzz_int_equals 64
+store char_long char long fuzz_char_key fuzz_char_compare fuzz_long fuzz_long_equals 100
+store int_point int "struct point" fuzz_int_key fuzz_int_compare fuzz_point fuzz_point_equals 1000
+store double_char double char fuzz_double_key fuzz_double_compare fuzz_char fuzz_char_equals 300
+store long_double long double fuzz_long_key fuzz_long_compare fuzz_double fuzz_double_equals 5000
+
+slot_map int int fuzz_int fuzz_int_equals
+slot_map point "struct point" fuzz_point fuzz_point_equals
+
+bitset int int 131072
+bitset unsigned unsigned 327680
+
+# The table of targets in the order above
+{
+	while read -r name; do echo "#include \"fuzz_$name.h\""; done < targets.list
+	echo
+	echo "const struct fuzz_target fuzz_targets[] = {"
+	while read -r name; do printf '\t{"%s", fuzz_%s},\n' "$name" "$name"; done < targets.list
+	echo "};"
+} > targets.h
+rm targets.list
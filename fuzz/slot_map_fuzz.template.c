@@ -0,0 +1,105 @@
+/*
+ * This template creates a fuzz target for a slot map generated by slot_map.template.c. The slot map
+ * is compared with an array of the live handles and their values. Handles of removed values are
+ * kept to check that they are rejected.
+ *
+ * There are four template parameters: NAME, TYPE, VALUE_OF and EQUALS. TYPE can be any type.
+ * VALUE_OF is a function that makes a TYPE from 32 random bits and EQUALS compares two TYPE values.
+ * The slot map must be generated into slot_map_NAME.h.
+ *
+ * The typedef below is just to make the template file syntactically correct c. It is a cgen comment
+ * and will be ignored.
+ */
+
+typedef int TYPE;
+
+// cgen header
+
+#include <stddef.h>
+#include <stdint.h>
+
+int fuzz_slot_map_NAME(const uint8_t *data, size_t size);
+// cgen source
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "fuzz.h"
+#include "slot_map_NAME.h"
+
+#define STALE 64
+
+/* Every live handle refers to its value and to a distinct position of the dense array. */
+static void fuzz_slot_map_NAME_check(struct slot_map_NAME *map, const uint64_t *handles, const TYPE *values, size_t n)
+{
+	assert(map->size == n);
+	for (size_t i = 0; i < n; i++) {
+		TYPE *t = slot_map_NAME_get(map, handles[i]);
+		assert(t != NULL && EQUALS(*t, values[i]));
+		assert(slot_map_NAME_handle(map, (size_t) (t - map->data)) == handles[i]);
+	}
+}
+
+int fuzz_slot_map_NAME(const uint8_t *data, size_t size)
+{
+	struct fuzz_input in = {data, size};
+	struct slot_map_NAME map;
+	slot_map_NAME_init(&map);
+	uint64_t *handles = malloc((size / 8 + 1) * sizeof(uint64_t));
+	TYPE *values = malloc((size / 8 + 1) * sizeof(TYPE));
+	size_t n = 0;
+	uint64_t stale[STALE] = {0};
+	size_t nstale = 0;
+
+	while (in.size > 0) {
+		uint32_t op = fuzz_next(&in);
+		uint32_t arg = fuzz_next(&in);
+		switch (op % 8) {
+		case 0:
+		case 1:
+		case 2: {
+			TYPE t = VALUE_OF(arg);
+			uint64_t handle = slot_map_NAME_insert(&map, t);
+			assert(handle != 0);
+			handles[n] = handle;
+			values[n] = t;
+			n++;
+			break;
+		}
+		case 3:
+		case 4: {
+			if (n == 0) break;
+			size_t i = arg % n;
+			assert(slot_map_NAME_remove(&map, handles[i]));
+			stale[nstale++ % STALE] = handles[i];
+			n--;
+			handles[i] = handles[n];
+			values[i] = values[n];
+			break;
+		}
+		case 5: {
+			uint64_t handle = stale[arg % STALE];
+			assert(!slot_map_NAME_remove(&map, handle));
+			assert(slot_map_NAME_get(&map, handle) == NULL);
+			break;
+		}
+		case 6: {
+			if (n == 0) break;
+			size_t i = arg % n;
+			TYPE *t = slot_map_NAME_get(&map, handles[i]);
+			assert(t != NULL && EQUALS(*t, values[i]));
+			break;
+		}
+		case 7:
+			if (arg % 16 == 0) fuzz_slot_map_NAME_check(&map, handles, values, n);
+			break;
+		}
+		assert(map.size == n);
+	}
+	fuzz_slot_map_NAME_check(&map, handles, values, n);
+
+	slot_map_NAME_free(&map);
+	free(handles);
+	free(values);
+	return 0;
+}
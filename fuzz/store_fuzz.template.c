@@ -0,0 +1,136 @@
+/*
+ * This template creates a fuzz target for a key value store generated by store.template.c. The keys
+ * are drawn from KEYS possible keys and the store is compared with an array that has a presence
+ * flag and a value for each possible key.
+ *
+ * The template parameters are NAME, KEY_TYPE, VALUE_TYPE, KEY_OF, COMPARE, VALUE_OF, EQUALS and
+ * KEYS. KEY_OF makes the key with a given index in [0, KEYS], in increasing key order. The key with
+ * index KEYS is only used as a range bound. COMPARE is the comparison function of the store.
+ * VALUE_OF makes a value from 32 random bits and EQUALS compares two values. The store must be
+ * generated into store_NAME.h.
+ *
+ * The typedefs below are just to make the template file syntactically correct c. It is a cgen
+ * comment and will be ignored.
+ */
+
+typedef int KEY_TYPE;
+typedef int VALUE_TYPE;
+
+// cgen header
+
+#include <stddef.h>
+#include <stdint.h>
+
+int fuzz_store_NAME(const uint8_t *data, size_t size);
+// cgen source
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "fuzz.h"
+#include "store_NAME.h"
+
+/* The tuples in [low, high) are compared with the present keys in [low, high) of the reference. */
+static void fuzz_store_NAME_check_range(struct kv_range_NAME *range, const bool *present, const VALUE_TYPE *values, size_t low, size_t high)
+{
+	for (size_t k = low; k < high; k++) {
+		if (!present[k]) continue;
+		struct kv_tuple_NAME *tuple = kv_range_NAME_next(range);
+		assert(tuple != NULL);
+		assert(COMPARE(tuple->key, KEY_OF(k)) == 0);
+		assert(EQUALS(tuple->value, values[k]));
+	}
+	assert(kv_range_NAME_next(range) == NULL);
+}
+
+int fuzz_store_NAME(const uint8_t *data, size_t size)
+{
+	struct fuzz_input in = {data, size};
+	struct kv_store_NAME store;
+	kv_store_NAME_init(&store, COMPARE);
+	bool *present = calloc(KEYS, sizeof(bool));
+	VALUE_TYPE *values = malloc(KEYS * sizeof(VALUE_TYPE));
+	size_t count = 0;
+
+	while (in.size > 0) {
+		uint32_t op = fuzz_next(&in);
+		size_t k = fuzz_next(&in) % KEYS;
+		size_t high = k + fuzz_next(&in) % (KEYS / 4 + 2);
+		if (high > KEYS) high = KEYS;
+		struct kv_range_NAME range;
+
+		switch (op % 8) {
+		case 0:
+		case 1: {
+			VALUE_TYPE value = VALUE_OF(fuzz_next(&in));
+			assert(kv_store_NAME_put(&store, KEY_OF(k), value) == present[k]);
+			count += !present[k];
+			present[k] = true;
+			values[k] = value;
+			break;
+		}
+		case 2: {
+			VALUE_TYPE *value = kv_store_NAME_get(&store, KEY_OF(k));
+			assert((value != NULL) == present[k]);
+			if (value != NULL) assert(EQUALS(*value, values[k]));
+			break;
+		}
+		case 3:
+			assert(kv_store_NAME_delete(&store, KEY_OF(k)) == present[k]);
+			count -= present[k];
+			present[k] = false;
+			break;
+		case 4: {
+			size_t deleted = 0;
+			for (size_t j = k; j < high; j++) {
+				deleted += present[j];
+				present[j] = false;
+			}
+			assert(kv_store_NAME_delete_range(&store, KEY_OF(k), KEY_OF(high)) == deleted);
+			count -= deleted;
+			break;
+		}
+		case 5:
+			assert(kv_store_NAME_range(&store, KEY_OF(k), KEY_OF(high), &range) == &range);
+			fuzz_store_NAME_check_range(&range, present, values, k, high);
+			break;
+		case 6: {
+			size_t below = 0;
+			for (size_t j = 0; j < k; j++) below += present[j];
+			assert(kv_store_NAME_lower_bound(&store, KEY_OF(k)) == below);
+			assert(kv_store_NAME_upper_bound(&store, KEY_OF(k)) == below + present[k]);
+			break;
+		}
+		case 7: {
+			/* A sorted batch of keys with repetitions */
+			KEY_TYPE keys[16];
+			size_t indices[16];
+			VALUE_TYPE *found[16];
+			size_t nkeys = op / 8 % 17;
+			size_t expected = 0;
+			for (size_t i = 0; i < nkeys; i++) {
+				indices[i] = k;
+				keys[i] = KEY_OF(k);
+				expected += present[k];
+				k += fuzz_next(&in) % 3;
+				if (k >= KEYS) k = KEYS - 1;
+			}
+			assert(kv_store_NAME_get_batch(&store, keys, nkeys, found) == expected);
+			for (size_t i = 0; i < nkeys; i++) {
+				assert((found[i] != NULL) == present[indices[i]]);
+				if (found[i] != NULL) assert(EQUALS(*found[i], values[indices[i]]));
+			}
+			break;
+		}
+		}
+		assert(store.size == count);
+	}
+
+	struct kv_range_NAME range;
+	fuzz_store_NAME_check_range(kv_store_NAME_range_all(&store, &range), present, values, 0, KEYS);
+
+	kv_store_NAME_free(&store);
+	free(present);
+	free(values);
+	return 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * This template creates a fuzz target for a vector generated by vector.template.c. The vector is
+ * compared with a plain array. The operations are append and set_capacity.
+ *
+ * There are four template parameters: NAME, TYPE, VALUE_OF and EQUALS. TYPE can be any type.
+ * VALUE_OF is a function that makes a TYPE from 32 random bits and EQUALS compares two TYPE values.
+ * The vector must be generated into vector_NAME.h.
+ *
+ * The typedef below is just to make the template file syntactically correct c. It is a cgen comment
+ * and will be ignored.
+ */
+
+typedef int TYPE;
+
+// cgen header
+
+#include <stddef.h>
+#include <stdint.h>
+
+int fuzz_vector_NAME(const uint8_t *data, size_t size);
+// cgen source
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "fuzz.h"
+#include "vector_NAME.h"
+
+static void fuzz_vector_NAME_check(const struct vector_NAME *vec, const TYPE *ref, size_t ref_size)
+{
+	assert(vec->size == ref_size);
+	assert(vec->size <= vec->capacity);
+	for (size_t i = 0; i < ref_size; i++) {
+		assert(EQUALS(vec->data[i], ref[i]));
+	}
+}
+
+int fuzz_vector_NAME(const uint8_t *data, size_t size)
+{
+	struct fuzz_input in = {data, size};
+	struct vector_NAME vec;
+	vector_NAME_init(&vec);
+	TYPE *ref = malloc((size / 8 + 1) * sizeof(TYPE));
+	size_t ref_size = 0;
+
+	while (in.size > 0) {
+		uint32_t op = fuzz_next(&in);
+		uint32_t arg = fuzz_next(&in);
+		if (op % 8 != 0) {
+			TYPE t = VALUE_OF(arg);
+			vector_NAME_append(&vec, t);
+			ref[ref_size++] = t;
+			assert(vec.size == ref_size);
+			assert(EQUALS(vec.data[vec.size - 1], t));
+		} else {
+			size_t capacity = arg % (2 * vec.size + 2);
+			vector_NAME_set_capacity(&vec, capacity);
+			assert(vec.capacity == capacity);
+			if (ref_size > capacity) ref_size = capacity;
+			fuzz_vector_NAME_check(&vec, ref, ref_size);
+		}
+	}
+	fuzz_vector_NAME_check(&vec, ref, ref_size);
+
+	vector_NAME_free(&vec);
+	free(ref);
+	return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ * This template creates a fuzz target for the bulk operations generated by vector_ops.template.c.
+ * Every operation is compared with a plain loop over a reference array, at a SIMD level chosen by
+ * the input.
+ *
+ * There are three template parameters: NAME, TYPE and VALUE_OF. TYPE is an arithmetic type and
+ * VALUE_OF is a function that makes a TYPE from 32 random bits. The operations must be generated
+ * into vector_ops_NAME.h, which includes the header of the vector.
+ *
+ * Floating point values are kept to small multiples of 1/4 and the vector to at most MAX_SIZE
+ * elements, so that every sum is exact in any order of addition and can be compared exactly.
+ * Integer sums, additions and multiplications wrap around. They are compared with a reference
+ * computed in uint64_t, whose low bits are the wrapped result, and are given scalars of any size so
+ * that the wrap around is reached.
+ *
+ * The typedef below is just to make the template file syntactically correct c. It is a cgen comment
+ * and will be ignored.
+ */
+
+typedef int TYPE;
+
+// cgen header
+
+#include <stddef.h>
+#include <stdint.h>
+
+int fuzz_vector_ops_NAME(const uint8_t *data, size_t size);
+// cgen source
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "fuzz.h"
+#include "vector_ops_NAME.h"
+
+#define MAX_SIZE 2048
+
+#define FLOATING ((TYPE) 0.5 != 0)
+
+static TYPE fuzz_vector_ops_NAME_add(TYPE a, TYPE b)
+{
+	if (FLOATING) return a + b;
+	return (TYPE) ((uint64_t) a + (uint64_t) b);
+}
+
+static TYPE fuzz_vector_ops_NAME_mul(TYPE a, TYPE b)
+{
+	if (FLOATING) return a * b;
+	return (TYPE) ((uint64_t) a * (uint64_t) b);
+}
+
+/* Floating point additions and multiplications are only done while all elements are at most 1000
+ * in magnitude.
+ */
+static bool fuzz_vector_ops_NAME_small(const TYPE *ref, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		if (ref[i] > 1000 || ref[i] < -1000) return false;
+	}
+	return true;
+}
+
+int fuzz_vector_ops_NAME(const uint8_t *data, size_t size)
+{
+	struct fuzz_input in = {data, size};
+	struct vector_NAME vec, out;
+	vector_NAME_init(&vec);
+	vector_NAME_init(&out);
+	TYPE *ref = malloc(MAX_SIZE * sizeof(TYPE));
+	size_t n = 0;
+
+	while (in.size > 0) {
+		uint32_t op = fuzz_next(&in);
+		uint32_t arg = fuzz_next(&in);
+		TYPE t = VALUE_OF(arg);
+		switch (op % 8) {
+		case 0: {
+			uint32_t count = arg % 64;
+			for (uint32_t i = 0; i < count && n < MAX_SIZE; i++) {
+				TYPE value = VALUE_OF(fuzz_next(&in));
+				vector_NAME_append(&vec, value);
+				ref[n++] = value;
+			}
+			assert(vec.size == n);
+			break;
+		}
+		case 1:
+			vector_NAME_set_simd_level((enum vector_NAME_simd) (arg % 3));
+			break;
+		case 2: {
+			if (n > 0 && op % 3 != 0) t = ref[arg % n];
+			size_t expected = 0;
+			while (expected < n && ref[expected] != t) expected++;
+			assert(vector_NAME_find(&vec, t) == expected);
+			break;
+		}
+		case 3: {
+			if (n > 0 && op % 3 != 0) t = ref[arg % n];
+			size_t expected = 0;
+			for (size_t i = 0; i < n; i++) expected += ref[i] == t;
+			assert(vector_NAME_count(&vec, t) == expected);
+			break;
+		}
+		case 4: {
+			TYPE min, max;
+			assert(vector_NAME_min(&vec, &min) == (n > 0));
+			assert(vector_NAME_max(&vec, &max) == (n > 0));
+			for (size_t i = 0; i < n; i++) {
+				assert(min <= ref[i] && ref[i] <= max);
+			}
+			if (n > 0) {
+				assert(vector_NAME_find(&vec, min) < n);
+				assert(vector_NAME_find(&vec, max) < n);
+			}
+			break;
+		}
+		case 5: {
+			TYPE expected = 0;
+			for (size_t i = 0; i < n; i++) expected = fuzz_vector_ops_NAME_add(expected, ref[i]);
+			assert(vector_NAME_sum(&vec) == expected);
+			break;
+		}
+		case 6: {
+			TYPE low = t;
+			TYPE high = VALUE_OF(fuzz_next(&in));
+			size_t start = op % 3 == 0 ? out.size : 0;
+			out.size = start;
+			assert(vector_NAME_filter(&out, &vec, low, high) == &out);
+			size_t j = start;
+			for (size_t i = 0; i < n; i++) {
+				if (ref[i] < low || ref[i] > high) continue;
+				assert(j < out.size && out.data[j] == ref[i]);
+				j++;
+			}
+			assert(j == out.size);
+			break;
+		}
+		case 7: {
+			if (FLOATING && !fuzz_vector_ops_NAME_small(ref, n)) break;
+			TYPE scalar = op / 8 % 2 ? t : (TYPE) arg;
+			if (op % 2 == 0) {
+				if (FLOATING) scalar = (TYPE) ((int) (arg % 7) - 3);
+				vector_NAME_add_scalar(&vec, scalar);
+				for (size_t i = 0; i < n; i++) ref[i] = fuzz_vector_ops_NAME_add(ref[i], scalar);
+			} else {
+				if (FLOATING) scalar = (TYPE) ((int) (arg % 5) - 2);
+				vector_NAME_mul_scalar(&vec, scalar);
+				for (size_t i = 0; i < n; i++) ref[i] = fuzz_vector_ops_NAME_mul(ref[i], scalar);
+			}
+			for (size_t i = 0; i < n; i++) {
+				assert(vec.data[i] == ref[i]);
+			}
+			break;
+		}
+		}
+	}
+
+	vector_NAME_free(&vec);
+	vector_NAME_free(&out);
+	free(ref);
+	return 0;
+}
@@ -0,0 +1,1133 @@
+/* This file is generated by the cgen program, https://github.com/morten-krogh/cgen. The cgen program is released under the MIT license.*/
+
+#include "bitset_int.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BITSET_SIMD
+#endif
+
+enum bitset_op_int {
+	bitset_int_op_and,
+	bitset_int_op_or,
+	bitset_int_op_xor,
+	bitset_int_op_andnot
+};
+
+static unsigned bitset_int_popcount64(uint64_t w)
+{
+#ifdef __GNUC__
+	return __builtin_popcountll(w);
+#else
+	w = w - ((w >> 1) & 0x5555555555555555);
+	w = (w & 0x3333333333333333) + ((w >> 2) & 0x3333333333333333);
+	w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0f;
+	return (w * 0x0101010101010101) >> 56;
+#endif
+}
+
+/* w must be non-zero */
+static unsigned bitset_int_ctz64(uint64_t w)
+{
+#ifdef __GNUC__
+	return __builtin_ctzll(w);
+#else
+	unsigned n = 0;
+	while ((w & 1) == 0) {
+		w >>= 1;
+		n++;
+	}
+	return n;
+#endif
+}
+
+/* The position of the bit with the given rank in w. rank must be less than the popcount of w. */
+static unsigned bitset_int_select64(uint64_t w, unsigned rank)
+{
+	for (unsigned i = 0; i < rank; i++) {
+		w &= w - 1;
+	}
+	return bitset_int_ctz64(w);
+}
+
+static void bitset_int_words_op_scalar(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n, enum bitset_op_int op)
+{
+	switch (op) {
+	case bitset_int_op_and: for (size_t i = 0; i < n; i++) dst[i] = a[i] & b[i]; break;
+	case bitset_int_op_or: for (size_t i = 0; i < n; i++) dst[i] = a[i] | b[i]; break;
+	case bitset_int_op_xor: for (size_t i = 0; i < n; i++) dst[i] = a[i] ^ b[i]; break;
+	case bitset_int_op_andnot: for (size_t i = 0; i < n; i++) dst[i] = a[i] & ~b[i]; break;
+	}
+}
+
+static size_t bitset_int_popcount_scalar(const uint64_t *words, size_t n)
+{
+	size_t count = 0;
+	for (size_t i = 0; i < n; i++) {
+		count += bitset_int_popcount64(words[i]);
+	}
+	return count;
+}
+
+#ifdef BITSET_SIMD
+
+/* The SIMD kernels work on 256 bit blocks of four words with the gcc vector extension. The bodies
+ * are inlined into an SSE2 and an AVX2 function. The kernels only use bitwise operations, shifts
+ * and additions, which the compiler splits into two 128 bit instructions in the SSE2 functions.
+ * Loads and stores go through memcpy because the words are only aligned for uint64_t.
+ */
+
+typedef uint64_t block_int __attribute__((vector_size(32)));
+
+enum { bitset_int_block_words = sizeof(block_int) / sizeof(uint64_t) };
+
+static inline __attribute__((always_inline))
+void bitset_int_words_op_body(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n, enum bitset_op_int op)
+{
+	size_t i = 0;
+	for (; i + bitset_int_block_words <= n; i += bitset_int_block_words) {
+		block_int x;
+		block_int y;
+		memcpy(&x, a + i, sizeof x);
+		memcpy(&y, b + i, sizeof y);
+		switch (op) {
+		case bitset_int_op_and: x &= y; break;
+		case bitset_int_op_or: x |= y; break;
+		case bitset_int_op_xor: x ^= y; break;
+		case bitset_int_op_andnot: x &= ~y; break;
+		}
+		memcpy(dst + i, &x, sizeof x);
+	}
+	bitset_int_words_op_scalar(dst + i, a + i, b + i, n - i, op);
+}
+
+/* The bits are counted in every word of a block in parallel by adding neighbouring bit fields. */
+static inline __attribute__((always_inline))
+size_t bitset_int_popcount_body(const uint64_t *words, size_t n)
+{
+	const block_int m1 = {0x5555555555555555, 0x5555555555555555, 0x5555555555555555, 0x5555555555555555};
+	const block_int m2 = {0x3333333333333333, 0x3333333333333333, 0x3333333333333333, 0x3333333333333333};
+	const block_int m4 = {0x0f0f0f0f0f0f0f0f, 0x0f0f0f0f0f0f0f0f, 0x0f0f0f0f0f0f0f0f, 0x0f0f0f0f0f0f0f0f};
+	const block_int m7 = {0x7f, 0x7f, 0x7f, 0x7f};
+	block_int acc = {0};
+	size_t i = 0;
+	for (; i + bitset_int_block_words <= n; i += bitset_int_block_words) {
+		block_int x;
+		memcpy(&x, words + i, sizeof x);
+		x = x - ((x >> 1) & m1);
+		x = (x & m2) + ((x >> 2) & m2);
+		x = (x + (x >> 4)) & m4;
+		x = x + (x >> 8);
+		x = x + (x >> 16);
+		x = x + (x >> 32);
+		acc += x & m7;
+	}
+	return acc[0] + acc[1] + acc[2] + acc[3] + bitset_int_popcount_scalar(words + i, n - i);
+}
+
+static __attribute__((target("sse2")))
+void bitset_int_words_op_sse2(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n, enum bitset_op_int op)
+{
+	bitset_int_words_op_body(dst, a, b, n, op);
+}
+
+static __attribute__((target("avx2")))
+void bitset_int_words_op_avx2(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n, enum bitset_op_int op)
+{
+	bitset_int_words_op_body(dst, a, b, n, op);
+}
+
+static __attribute__((target("sse2")))
+size_t bitset_int_popcount_sse2(const uint64_t *words, size_t n)
+{
+	return bitset_int_popcount_body(words, n);
+}
+
+static __attribute__((target("avx2")))
+size_t bitset_int_popcount_avx2(const uint64_t *words, size_t n)
+{
+	return bitset_int_popcount_body(words, n);
+}
+
+#endif
+
+/* The level used by the operations. It is only written by bitset_int_set_simd_level. */
+static enum bitset_int_simd bitset_int_level = bitset_int_simd_scalar;
+
+/* The level is used for all subsequent operations on dense and roaring bitsets. The return value
+ * is the level actually used which is lower than the argument if the compiler or cpu does not
+ * support the argument. The level is not synchronized with operations running in other threads.
+ * Before main is entered it is set to the best supported level.
+ */
+enum bitset_int_simd bitset_int_set_simd_level(enum bitset_int_simd level)
+{
+	enum bitset_int_simd supported = bitset_int_simd_scalar;
+#ifdef BITSET_SIMD
+	if (__builtin_cpu_supports("avx2")) supported = bitset_int_simd_avx2;
+	else if (__builtin_cpu_supports("sse2")) supported = bitset_int_simd_sse2;
+#endif
+	bitset_int_level = level < supported ? level : supported;
+	return bitset_int_level;
+}
+
+enum bitset_int_simd bitset_int_simd_level(void)
+{
+	return bitset_int_level;
+}
+
+#ifdef BITSET_SIMD
+/* Constructors can run before the cpu model used by __builtin_cpu_supports is initialized, so it is
+ * initialized here first.
+ */
+static __attribute__((constructor)) void bitset_int_init_simd_level(void)
+{
+	__builtin_cpu_init();
+	bitset_int_set_simd_level(bitset_int_simd_avx2);
+}
+#endif
+
+/* dst[i] = a[i] op b[i] for i < n. dst may be equal to a or b. */
+static void bitset_int_words_op(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n, enum bitset_op_int op)
+{
+	switch (bitset_int_simd_level()) {
+#ifdef BITSET_SIMD
+	case bitset_int_simd_avx2: bitset_int_words_op_avx2(dst, a, b, n, op); break;
+	case bitset_int_simd_sse2: bitset_int_words_op_sse2(dst, a, b, n, op); break;
+#endif
+	default: bitset_int_words_op_scalar(dst, a, b, n, op); break;
+	}
+}
+
+static size_t bitset_int_popcount(const uint64_t *words, size_t n)
+{
+	switch (bitset_int_simd_level()) {
+#ifdef BITSET_SIMD
+	case bitset_int_simd_avx2: return bitset_int_popcount_avx2(words, n);
+	case bitset_int_simd_sse2: return bitset_int_popcount_sse2(words, n);
+#endif
+	default: return bitset_int_popcount_scalar(words, n);
+	}
+}
+
+/* Dense bitset */
+
+struct bitset_int *bitset_int_init(struct bitset_int *set)
+{
+	set->words = NULL;
+	set->size = 0;
+	set->capacity = 0;
+
+	return set;
+}
+
+void bitset_int_free(struct bitset_int *set)
+{
+	free(set->words);
+}
+
+/* The set is extended with zero words to at least size words. The bool return value is false if
+ * memory could not be allocated.
+ */
+static bool bitset_int_resize(struct bitset_int *set, size_t size)
+{
+	if (size > set->capacity) {
+		size_t new_capacity = 2 * set->capacity + 1;
+		if (new_capacity < size) new_capacity = size;
+		uint64_t *new_words = realloc(set->words, new_capacity * sizeof(uint64_t));
+		if (new_words == NULL) return false;
+		set->words = new_words;
+		set->capacity = new_capacity;
+	}
+	if (size > set->size) {
+		memset(set->words + set->size, 0, (size - set->size) * sizeof(uint64_t));
+		set->size = size;
+	}
+	return true;
+}
+
+/* The value is added to the set. The bool return value is true if the value was present and false
+ * if the value was absent. false is also returned if memory could not be allocated, and the value
+ * is then not added. A caller can detect this as false from bitset_int_add followed by false from
+ * bitset_int_contains.
+ */
+bool bitset_int_add(struct bitset_int *set, int value)
+{
+	size_t word = (size_t) value / 64;
+	uint64_t bit = (uint64_t) 1 << ((size_t) value % 64);
+	if (word >= set->size && !bitset_int_resize(set, word + 1)) return false;
+
+	bool present = (set->words[word] & bit) != 0;
+	set->words[word] |= bit;
+	return present;
+}
+
+/* The value is removed from the set. The bool return value is true if the value was present and
+ * false if the value was absent.
+ */
+bool bitset_int_remove(struct bitset_int *set, int value)
+{
+	size_t word = (size_t) value / 64;
+	uint64_t bit = (uint64_t) 1 << ((size_t) value % 64);
+	if (word >= set->size) return false;
+
+	bool present = (set->words[word] & bit) != 0;
+	set->words[word] &= ~bit;
+	return present;
+}
+
+bool bitset_int_contains(const struct bitset_int *set, int value)
+{
+	size_t word = (size_t) value / 64;
+	if (word >= set->size) return false;
+	return (set->words[word] >> ((size_t) value % 64)) & 1;
+}
+
+size_t bitset_int_cardinality(const struct bitset_int *set)
+{
+	return bitset_int_popcount(set->words, set->size);
+}
+
+/* dst = a op b. dst may be equal to a or b. Words beyond the size of a set are zero. dst is
+ * returned, or NULL if memory could not be allocated.
+ */
+static struct bitset_int *bitset_int_op(struct bitset_int *dst, const struct bitset_int *a, const struct bitset_int *b, enum bitset_op_int op)
+{
+	size_t a_size = a->size;
+	size_t b_size = b->size;
+	size_t common = a_size < b_size ? a_size : b_size;
+	size_t size;
+	switch (op) {
+	case bitset_int_op_and: size = common; break;
+	case bitset_int_op_andnot: size = a_size; break;
+	default: size = a_size > b_size ? a_size : b_size; break;
+	}
+
+	if (!bitset_int_resize(dst, size)) return NULL;
+
+	bitset_int_words_op(dst->words, a->words, b->words, common, op);
+	if (size > common) {
+		const struct bitset_int *longer = a_size > b_size ? a : b;
+		memmove(dst->words + common, longer->words + common, (size - common) * sizeof(uint64_t));
+	}
+	dst->size = size;
+
+	return dst;
+}
+
+struct bitset_int *bitset_int_and(struct bitset_int *dst, const struct bitset_int *a, const struct bitset_int *b)
+{
+	return bitset_int_op(dst, a, b, bitset_int_op_and);
+}
+
+struct bitset_int *bitset_int_or(struct bitset_int *dst, const struct bitset_int *a, const struct bitset_int *b)
+{
+	return bitset_int_op(dst, a, b, bitset_int_op_or);
+}
+
+struct bitset_int *bitset_int_xor(struct bitset_int *dst, const struct bitset_int *a, const struct bitset_int *b)
+{
+	return bitset_int_op(dst, a, b, bitset_int_op_xor);
+}
+
+struct bitset_int *bitset_int_andnot(struct bitset_int *dst, const struct bitset_int *a, const struct bitset_int *b)
+{
+	return bitset_int_op(dst, a, b, bitset_int_op_andnot);
+}
+
+/* The number of elements less than or equal to value is returned. */
+size_t bitset_int_rank(const struct bitset_int *set, int value)
+{
+	size_t word = (size_t) value / 64;
+	if (word >= set->size) return bitset_int_cardinality(set);
+
+	uint64_t mask = ((uint64_t) 2 << ((size_t) value % 64)) - 1;
+	return bitset_int_popcount(set->words, word) + bitset_int_popcount64(set->words[word] & mask);
+}
+
+/* The element with the given rank, counted from zero in increasing order, is written to value.
+ * The bool return value is false if rank is not less than the cardinality.
+ */
+bool bitset_int_select(const struct bitset_int *set, size_t rank, int *value)
+{
+	for (size_t i = 0; i < set->size; i++) {
+		unsigned count = bitset_int_popcount64(set->words[i]);
+		if (rank < count) {
+			*value = (int) (64 * i + bitset_int_select64(set->words[i], rank));
+			return true;
+		}
+		rank -= count;
+	}
+	return false;
+}
+
+/* The elements are iterated in increasing order. The set must not be modified during iteration. */
+void bitset_int_iter_init(struct bitset_iter_int *iter, const struct bitset_int *set)
+{
+	iter->set = set;
+	iter->word = 0;
+	iter->bits = set->size > 0 ? set->words[0] : 0;
+}
+
+/* The next element is written to value. The bool return value is false at the end of the set. */
+bool bitset_int_iter_next(struct bitset_iter_int *iter, int *value)
+{
+	while (iter->bits == 0) {
+		iter->word++;
+		if (iter->word >= iter->set->size) return false;
+		iter->bits = iter->set->words[iter->word];
+	}
+	*value = (int) (64 * iter->word + bitset_int_ctz64(iter->bits));
+	iter->bits &= iter->bits - 1;
+	return true;
+}
+
+/* Roaring bitset */
+
+#define ROARING_BITMAP_WORDS 1024
+#define ROARING_ARRAY_MAX 4096
+
+/* The index of the first value in values that is not less than low. */
+static uint32_t roaring_int_lower_bound(const uint16_t *values, uint32_t size, uint16_t low)
+{
+	uint32_t begin = 0;
+	uint32_t end = size;
+	while (begin < end) {
+		uint32_t middle = begin + (end - begin) / 2;
+		if (values[middle] < low) {
+			begin = middle + 1;
+		} else {
+			end = middle;
+		}
+	}
+	return begin;
+}
+
+/* The index of the last run starting at or below low, or -1 if there is none. */
+static int32_t roaring_int_run_search(const uint16_t *runs, uint32_t size, uint16_t low)
+{
+	uint32_t begin = 0;
+	uint32_t end = size;
+	while (begin < end) {
+		uint32_t middle = begin + (end - begin) / 2;
+		if (runs[2 * middle] <= low) {
+			begin = middle + 1;
+		} else {
+			end = middle;
+		}
+	}
+	return (int32_t) begin - 1;
+}
+
+/* The bits from start to end, both included, are set. */
+static void roaring_int_set_range(uint64_t *words, uint32_t start, uint32_t end)
+{
+	uint32_t first = start / 64;
+	uint32_t last = end / 64;
+	uint64_t first_mask = ~(uint64_t) 0 << (start % 64);
+	uint64_t last_mask = ((uint64_t) 2 << (end % 64)) - 1;
+	if (first == last) {
+		words[first] |= first_mask & last_mask;
+		return;
+	}
+	words[first] |= first_mask;
+	for (uint32_t i = first + 1; i < last; i++) {
+		words[i] = ~(uint64_t) 0;
+	}
+	words[last] |= last_mask;
+}
+
+/* The position of the first bit at or after start with the given value, or 65536 if there is none */
+static uint32_t roaring_int_next_bit(const uint64_t *words, uint32_t start, bool value)
+{
+	uint32_t i = start / 64;
+	if (i >= ROARING_BITMAP_WORDS) return 65536;
+	uint64_t w = (value ? words[i] : ~words[i]) & (~(uint64_t) 0 << (start % 64));
+	while (w == 0) {
+		i++;
+		if (i == ROARING_BITMAP_WORDS) return 65536;
+		w = value ? words[i] : ~words[i];
+	}
+	return 64 * i + bitset_int_ctz64(w);
+}
+
+static bool roaring_int_container_contains(const struct roaring_container_int *c, uint16_t low)
+{
+	switch (c->kind) {
+	case roaring_int_array: {
+		uint32_t index = roaring_int_lower_bound(c->data.array, c->size, low);
+		return index < c->size && c->data.array[index] == low;
+	}
+	case roaring_int_bitmap:
+		return (c->data.bitmap[low / 64] >> (low % 64)) & 1;
+	default: {
+		int32_t index = roaring_int_run_search(c->data.runs, c->size, low);
+		return index >= 0 && low - c->data.runs[2 * index] <= c->data.runs[2 * index + 1];
+	}
+	}
+}
+
+/* The container is written to words which must have ROARING_BITMAP_WORDS words. */
+static void roaring_int_container_to_bitmap(const struct roaring_container_int *c, uint64_t *words)
+{
+	if (c->kind == roaring_int_bitmap) {
+		memcpy(words, c->data.bitmap, ROARING_BITMAP_WORDS * sizeof(uint64_t));
+		return;
+	}
+	memset(words, 0, ROARING_BITMAP_WORDS * sizeof(uint64_t));
+	if (c->kind == roaring_int_array) {
+		for (uint32_t i = 0; i < c->size; i++) {
+			uint16_t low = c->data.array[i];
+			words[low / 64] |= (uint64_t) 1 << (low % 64);
+		}
+	} else {
+		for (uint32_t i = 0; i < c->size; i++) {
+			uint32_t start = c->data.runs[2 * i];
+			roaring_int_set_range(words, start, start + c->data.runs[2 * i + 1]);
+		}
+	}
+}
+
+/* The container data is replaced by an array or bitmap built from words which has cardinality
+ * bits. The old data of c is not freed. The bool return value is false if memory could not be
+ * allocated in which case c is untouched.
+ */
+static bool roaring_int_container_from_bitmap(struct roaring_container_int *c, const uint64_t *words, uint32_t cardinality)
+{
+	if (cardinality > ROARING_ARRAY_MAX) {
+		uint64_t *bitmap = malloc(ROARING_BITMAP_WORDS * sizeof(uint64_t));
+		if (bitmap == NULL) return false;
+		memcpy(bitmap, words, ROARING_BITMAP_WORDS * sizeof(uint64_t));
+		c->kind = roaring_int_bitmap;
+		c->size = ROARING_BITMAP_WORDS;
+		c->capacity = ROARING_BITMAP_WORDS;
+		c->data.bitmap = bitmap;
+	} else {
+		uint16_t *array = malloc((cardinality > 0 ? cardinality : 1) * sizeof(uint16_t));
+		if (array == NULL) return false;
+		uint32_t size = 0;
+		for (uint32_t i = 0; i < ROARING_BITMAP_WORDS; i++) {
+			for (uint64_t w = words[i]; w != 0; w &= w - 1) {
+				array[size++] = (uint16_t) (64 * i + bitset_int_ctz64(w));
+			}
+		}
+		c->kind = roaring_int_array;
+		c->size = cardinality;
+		c->capacity = cardinality;
+		c->data.array = array;
+	}
+	c->cardinality = cardinality;
+	return true;
+}
+
+/* A run container is converted to an array or bitmap before it is modified. */
+static bool roaring_int_container_unrun(struct roaring_container_int *c)
+{
+	if (c->kind != roaring_int_run) return true;
+
+	uint64_t words[ROARING_BITMAP_WORDS];
+	roaring_int_container_to_bitmap(c, words);
+	uint16_t *runs = c->data.runs;
+	if (!roaring_int_container_from_bitmap(c, words, c->cardinality)) return false;
+	free(runs);
+	return true;
+}
+
+static void roaring_int_container_free(struct roaring_container_int *c)
+{
+	free(c->data.array);
+}
+
+/* The bool return value is true if low was present. It is false if low was absent or memory could
+ * not be allocated, in which case low is still absent. A present low is found before a run container
+ * is converted, so that the conversion can only fail for an absent low.
+ */
+static bool roaring_int_container_add(struct roaring_container_int *c, uint16_t low)
+{
+	if (c->kind == roaring_int_run && roaring_int_container_contains(c, low)) return true;
+	if (!roaring_int_container_unrun(c)) return false;
+
+	if (c->kind == roaring_int_bitmap) {
+		uint64_t bit = (uint64_t) 1 << (low % 64);
+		if (c->data.bitmap[low / 64] & bit) return true;
+		c->data.bitmap[low / 64] |= bit;
+		c->cardinality++;
+		return false;
+	}
+
+	uint32_t index = roaring_int_lower_bound(c->data.array, c->size, low);
+	if (index < c->size && c->data.array[index] == low) return true;
+
+	if (c->size == ROARING_ARRAY_MAX) {
+		uint64_t words[ROARING_BITMAP_WORDS];
+		roaring_int_container_to_bitmap(c, words);
+		words[low / 64] |= (uint64_t) 1 << (low % 64);
+		uint16_t *array = c->data.array;
+		if (roaring_int_container_from_bitmap(c, words, c->cardinality + 1)) free(array);
+		return false;
+	}
+
+	if (c->size == c->capacity) {
+		uint32_t new_capacity = 2 * c->capacity + 1;
+		if (new_capacity > ROARING_ARRAY_MAX) new_capacity = ROARING_ARRAY_MAX;
+		uint16_t *new_array = realloc(c->data.array, new_capacity * sizeof(uint16_t));
+		if (new_array == NULL) return false;
+		c->data.array = new_array;
+		c->capacity = new_capacity;
+	}
+	memmove(c->data.array + index + 1, c->data.array + index, (c->size - index) * sizeof(uint16_t));
+	c->data.array[index] = low;
+	c->size++;
+	c->cardinality++;
+	return false;
+}
+
+/* The bool return value is true if low was present and false if low was absent or memory could not
+ * be allocated to convert a run container, in which case low is still present.
+ */
+static bool roaring_int_container_remove(struct roaring_container_int *c, uint16_t low)
+{
+	if (!roaring_int_container_contains(c, low)) return false;
+	if (!roaring_int_container_unrun(c)) return false;
+
+	if (c->kind == roaring_int_bitmap) {
+		c->data.bitmap[low / 64] &= ~((uint64_t) 1 << (low % 64));
+		c->cardinality--;
+		if (c->cardinality == ROARING_ARRAY_MAX) {
+			uint64_t *bitmap = c->data.bitmap;
+			if (roaring_int_container_from_bitmap(c, bitmap, c->cardinality)) free(bitmap);
+		}
+		return true;
+	}
+
+	uint32_t index = roaring_int_lower_bound(c->data.array, c->size, low);
+	memmove(c->data.array + index, c->data.array + index + 1, (c->size - index - 1) * sizeof(uint16_t));
+	c->size--;
+	c->cardinality--;
+	return true;
+}
+
+/* The number of elements less than or equal to low */
+static uint32_t roaring_int_container_rank(const struct roaring_container_int *c, uint16_t low)
+{
+	switch (c->kind) {
+	case roaring_int_array: {
+		uint32_t index = roaring_int_lower_bound(c->data.array, c->size, low);
+		return index + (index < c->size && c->data.array[index] == low);
+	}
+	case roaring_int_bitmap: {
+		uint64_t mask = ((uint64_t) 2 << (low % 64)) - 1;
+		return bitset_int_popcount(c->data.bitmap, low / 64) + bitset_int_popcount64(c->data.bitmap[low / 64] & mask);
+	}
+	default: {
+		uint32_t rank = 0;
+		for (uint32_t i = 0; i < c->size && c->data.runs[2 * i] <= low; i++) {
+			uint32_t length = (uint32_t) c->data.runs[2 * i + 1] + 1;
+			uint32_t below = (uint32_t) low - c->data.runs[2 * i] + 1;
+			rank += below < length ? below : length;
+		}
+		return rank;
+	}
+	}
+}
+
+/* rank must be less than the cardinality of c */
+static uint16_t roaring_int_container_select(const struct roaring_container_int *c, uint32_t rank)
+{
+	switch (c->kind) {
+	case roaring_int_array:
+		return c->data.array[rank];
+	case roaring_int_bitmap:
+		for (uint32_t i = 0;; i++) {
+			unsigned count = bitset_int_popcount64(c->data.bitmap[i]);
+			if (rank < count) return (uint16_t) (64 * i + bitset_int_select64(c->data.bitmap[i], rank));
+			rank -= count;
+		}
+	default:
+		for (uint32_t i = 0;; i++) {
+			uint32_t length = (uint32_t) c->data.runs[2 * i + 1] + 1;
+			if (rank < length) return (uint16_t) (c->data.runs[2 * i] + rank);
+			rank -= length;
+		}
+	}
+}
+
+static size_t roaring_int_container_bytes(const struct roaring_container_int *c)
+{
+	switch (c->kind) {
+	case roaring_int_array: return c->capacity * sizeof(uint16_t);
+	case roaring_int_bitmap: return ROARING_BITMAP_WORDS * sizeof(uint64_t);
+	default: return 2 * c->capacity * sizeof(uint16_t);
+	}
+}
+
+static bool roaring_int_container_copy(struct roaring_container_int *dst, const struct roaring_container_int *src)
+{
+	size_t bytes = roaring_int_container_bytes(src);
+	void *data = malloc(bytes > 0 ? bytes : 1);
+	if (data == NULL) return false;
+	memcpy(data, src->data.array, bytes);
+	*dst = *src;
+	dst->data.array = data;
+	return true;
+}
+
+/* c becomes an array container of the first size values of out, which has room for capacity
+ * values. out is shrunk to size values so that a selective operation does not keep the room of its
+ * inputs, and freed if size is 0. If the shrinking realloc fails the larger array is kept.
+ */
+static void roaring_int_container_set_array(struct roaring_container_int *c, uint16_t *out, uint32_t size, uint32_t capacity)
+{
+	if (size == 0) {
+		free(out);
+		out = NULL;
+		capacity = 0;
+	} else if (size < capacity) {
+		uint16_t *trimmed = realloc(out, size * sizeof(uint16_t));
+		if (trimmed != NULL) {
+			out = trimmed;
+			capacity = size;
+		}
+	}
+
+	c->kind = roaring_int_array;
+	c->cardinality = size;
+	c->size = size;
+	c->capacity = capacity;
+	c->data.array = out;
+}
+
+/* The sorted arrays of a and b are merged into c. */
+static bool roaring_int_container_merge(struct roaring_container_int *c, const struct roaring_container_int *a, const struct roaring_container_int *b, enum bitset_op_int op)
+{
+	uint16_t *out = malloc((a->size + b->size > 0 ? a->size + b->size : 1) * sizeof(uint16_t));
+	if (out == NULL) return false;
+
+	const uint16_t *x = a->data.array;
+	const uint16_t *y = b->data.array;
+	bool keep_a = op != bitset_int_op_and;
+	bool keep_b = op == bitset_int_op_or || op == bitset_int_op_xor;
+	bool keep_both = op == bitset_int_op_and || op == bitset_int_op_or;
+	uint32_t i = 0;
+	uint32_t j = 0;
+	uint32_t size = 0;
+	while (i < a->size && j < b->size) {
+		if (x[i] < y[j]) {
+			if (keep_a) out[size++] = x[i];
+			i++;
+		} else if (y[j] < x[i]) {
+			if (keep_b) out[size++] = y[j];
+			j++;
+		} else {
+			if (keep_both) out[size++] = x[i];
+			i++;
+			j++;
+		}
+	}
+	for (; keep_a && i < a->size; i++) out[size++] = x[i];
+	for (; keep_b && j < b->size; j++) out[size++] = y[j];
+
+	if (size > ROARING_ARRAY_MAX) {
+		uint64_t words[ROARING_BITMAP_WORDS] = {0};
+		for (uint32_t k = 0; k < size; k++) {
+			words[out[k] / 64] |= (uint64_t) 1 << (out[k] % 64);
+		}
+		free(out);
+		return roaring_int_container_from_bitmap(c, words, size);
+	}
+
+	roaring_int_container_set_array(c, out, size, a->size + b->size);
+	return true;
+}
+
+/* The values of array container a that are, or are not, in b are written to c. */
+static bool roaring_int_container_filter(struct roaring_container_int *c, const struct roaring_container_int *a, const struct roaring_container_int *b, bool keep_present)
+{
+	uint16_t *out = malloc((a->size > 0 ? a->size : 1) * sizeof(uint16_t));
+	if (out == NULL) return false;
+
+	uint32_t size = 0;
+	for (uint32_t i = 0; i < a->size; i++) {
+		out[size] = a->data.array[i];
+		size += roaring_int_container_contains(b, a->data.array[i]) == keep_present;
+	}
+
+	roaring_int_container_set_array(c, out, size, a->size);
+	return true;
+}
+
+/* c = a op b for two containers with the same key. Two arrays are merged. An array intersected
+ * with, or subtracted by, another container is filtered by membership. All other combinations are
+ * done on bitmaps with the SIMD word kernels.
+ */
+static bool roaring_int_container_op(struct roaring_container_int *c, const struct roaring_container_int *a, const struct roaring_container_int *b, enum bitset_op_int op)
+{
+	c->key = a->key;
+	if (a->kind == roaring_int_array && b->kind == roaring_int_array) {
+		return roaring_int_container_merge(c, a, b, op);
+	}
+	if (a->kind == roaring_int_array && (op == bitset_int_op_and || op == bitset_int_op_andnot)) {
+		return roaring_int_container_filter(c, a, b, op == bitset_int_op_and);
+	}
+	if (b->kind == roaring_int_array && op == bitset_int_op_and) {
+		return roaring_int_container_filter(c, b, a, true);
+	}
+
+	uint64_t a_words[ROARING_BITMAP_WORDS];
+	uint64_t b_words[ROARING_BITMAP_WORDS];
+	const uint64_t *x = a->data.bitmap;
+	const uint64_t *y = b->data.bitmap;
+	if (a->kind != roaring_int_bitmap) {
+		roaring_int_container_to_bitmap(a, a_words);
+		x = a_words;
+	}
+	if (b->kind != roaring_int_bitmap) {
+		roaring_int_container_to_bitmap(b, b_words);
+		y = b_words;
+	}
+	bitset_int_words_op(a_words, x, y, ROARING_BITMAP_WORDS, op);
+	uint32_t cardinality = (uint32_t) bitset_int_popcount(a_words, ROARING_BITMAP_WORDS);
+	return roaring_int_container_from_bitmap(c, a_words, cardinality);
+}
+
+/* The container is converted to runs if that takes less memory. Runs take 4 bytes each, array
+ * values 2 bytes each and a bitmap 8192 bytes.
+ */
+static void roaring_int_container_run_optimize(struct roaring_container_int *c)
+{
+	if (c->kind == roaring_int_run) return;
+
+	uint64_t words[ROARING_BITMAP_WORDS];
+	roaring_int_container_to_bitmap(c, words);
+	uint32_t nruns = 0;
+	uint64_t carry = 0;
+	for (uint32_t i = 0; i < ROARING_BITMAP_WORDS; i++) {
+		uint64_t starts = words[i] & ~((words[i] << 1) | carry);
+		nruns += bitset_int_popcount64(starts);
+		carry = words[i] >> 63;
+	}
+
+	size_t run_bytes = 4 * (size_t) nruns;
+	size_t bytes = c->kind == roaring_int_array ? 2 * (size_t) c->cardinality : ROARING_BITMAP_WORDS * sizeof(uint64_t);
+	if (run_bytes >= bytes) return;
+
+	uint16_t *runs = malloc(run_bytes);
+	if (runs == NULL) return;
+	uint32_t start = roaring_int_next_bit(words, 0, true);
+	for (uint32_t i = 0; i < nruns; i++) {
+		uint32_t end = roaring_int_next_bit(words, start, false);
+		runs[2 * i] = (uint16_t) start;
+		runs[2 * i + 1] = (uint16_t) (end - start - 1);
+		start = roaring_int_next_bit(words, end, true);
+	}
+
+	roaring_int_container_free(c);
+	c->kind = roaring_int_run;
+	c->size = nruns;
+	c->capacity = nruns;
+	c->data.runs = runs;
+}
+
+struct roaring_int *roaring_int_init(struct roaring_int *set)
+{
+	set->containers = NULL;
+	set->size = 0;
+	set->capacity = 0;
+
+	return set;
+}
+
+void roaring_int_free(struct roaring_int *set)
+{
+	for (size_t i = 0; i < set->size; i++) {
+		roaring_int_container_free(set->containers + i);
+	}
+	free(set->containers);
+}
+
+/* The index of the container with key, or the index where it would be inserted. The bool return
+ * value is true if the container is present.
+ */
+static bool roaring_int_search(const struct roaring_int *set, uint16_t key, size_t *index)
+{
+	size_t begin = 0;
+	size_t end = set->size;
+	while (begin < end) {
+		size_t middle = begin + (end - begin) / 2;
+		if (set->containers[middle].key < key) {
+			begin = middle + 1;
+		} else {
+			end = middle;
+		}
+	}
+	*index = begin;
+	return begin < set->size && set->containers[begin].key == key;
+}
+
+/* Room is made for a container at index. The bool return value is false if memory could not be
+ * allocated.
+ */
+static bool roaring_int_insert(struct roaring_int *set, size_t index)
+{
+	if (set->size == set->capacity) {
+		size_t new_capacity = 2 * set->capacity + 1;
+		struct roaring_container_int *new_containers = realloc(set->containers, new_capacity * sizeof(struct roaring_container_int));
+		if (new_containers == NULL) return false;
+		set->containers = new_containers;
+		set->capacity = new_capacity;
+	}
+	memmove(set->containers + index + 1, set->containers + index, (set->size - index) * sizeof(struct roaring_container_int));
+	set->size++;
+	return true;
+}
+
+/* The value is added to the set. The bool return value is true if the value was present and false
+ * if the value was absent. false is also returned if memory could not be allocated, and the value
+ * is then not added. A caller can detect this as false from roaring_int_add followed by false from
+ * roaring_int_contains.
+ */
+bool roaring_int_add(struct roaring_int *set, int value)
+{
+	uint16_t key = (uint32_t) value >> 16;
+	uint16_t low = (uint32_t) value & 0xffff;
+	size_t index;
+	if (!roaring_int_search(set, key, &index)) {
+		if (!roaring_int_insert(set, index)) return false;
+		struct roaring_container_int *c = set->containers + index;
+		c->key = key;
+		c->kind = roaring_int_array;
+		c->cardinality = 0;
+		c->size = 0;
+		c->capacity = 0;
+		c->data.array = NULL;
+	}
+
+	struct roaring_container_int *c = set->containers + index;
+	bool present = roaring_int_container_add(c, low);
+	if (c->cardinality == 0) {
+		roaring_int_container_free(c);
+		memmove(c, c + 1, (set->size - index - 1) * sizeof(struct roaring_container_int));
+		set->size--;
+	}
+	return present;
+}
+
+/* The value is removed from the set. The bool return value is true if the value was present and
+ * false if the value was absent. Removal from a run container needs memory to convert the
+ * container. If that fails, false is returned and the value stays in the set, which a caller can
+ * detect with roaring_int_contains.
+ */
+bool roaring_int_remove(struct roaring_int *set, int value)
+{
+	uint16_t key = (uint32_t) value >> 16;
+	uint16_t low = (uint32_t) value & 0xffff;
+	size_t index;
+	if (!roaring_int_search(set, key, &index)) return false;
+
+	struct roaring_container_int *c = set->containers + index;
+	bool present = roaring_int_container_remove(c, low);
+	if (c->cardinality == 0) {
+		roaring_int_container_free(c);
+		memmove(c, c + 1, (set->size - index - 1) * sizeof(struct roaring_container_int));
+		set->size--;
+	}
+	return present;
+}
+
+bool roaring_int_contains(const struct roaring_int *set, int value)
+{
+	size_t index;
+	if (!roaring_int_search(set, (uint32_t) value >> 16, &index)) return false;
+	return roaring_int_container_contains(set->containers + index, (uint32_t) value & 0xffff);
+}
+
+size_t roaring_int_cardinality(const struct roaring_int *set)
+{
+	size_t cardinality = 0;
+	for (size_t i = 0; i < set->size; i++) {
+		cardinality += set->containers[i].cardinality;
+	}
+	return cardinality;
+}
+
+/* The heap memory used by the set */
+size_t roaring_int_size_in_bytes(const struct roaring_int *set)
+{
+	size_t bytes = set->capacity * sizeof(struct roaring_container_int);
+	for (size_t i = 0; i < set->size; i++) {
+		bytes += roaring_int_container_bytes(set->containers + i);
+	}
+	return bytes;
+}
+
+/* The container c is appended to set, or freed if it is empty. */
+static bool roaring_int_append(struct roaring_int *set, struct roaring_container_int *c)
+{
+	if (c->cardinality == 0) {
+		roaring_int_container_free(c);
+		return true;
+	}
+	if (!roaring_int_insert(set, set->size)) {
+		roaring_int_container_free(c);
+		return false;
+	}
+	set->containers[set->size - 1] = *c;
+	return true;
+}
+
+/* dst = a op b. dst may be equal to a or b. The containers of a and b are visited in key order and
+ * the result is built in a new set which replaces the previous content of dst at the end. dst is
+ * returned, or NULL if memory could not be allocated in which case dst is unchanged.
+ */
+static struct roaring_int *roaring_int_op(struct roaring_int *dst, const struct roaring_int *a, const struct roaring_int *b, enum bitset_op_int op)
+{
+	struct roaring_int result;
+	roaring_int_init(&result);
+
+	bool keep_a = op != bitset_int_op_and;
+	bool keep_b = op == bitset_int_op_or || op == bitset_int_op_xor;
+	size_t i = 0;
+	size_t j = 0;
+	while (i < a->size || j < b->size) {
+		struct roaring_container_int c;
+		bool ok = true;
+		if (j == b->size || (i < a->size && a->containers[i].key < b->containers[j].key)) {
+			if (keep_a) ok = roaring_int_container_copy(&c, a->containers + i) && roaring_int_append(&result, &c);
+			i++;
+		} else if (i == a->size || b->containers[j].key < a->containers[i].key) {
+			if (keep_b) ok = roaring_int_container_copy(&c, b->containers + j) && roaring_int_append(&result, &c);
+			j++;
+		} else {
+			ok = roaring_int_container_op(&c, a->containers + i, b->containers + j, op) && roaring_int_append(&result, &c);
+			i++;
+			j++;
+		}
+		if (!ok) {
+			roaring_int_free(&result);
+			return NULL;
+		}
+	}
+
+	roaring_int_free(dst);
+	*dst = result;
+	return dst;
+}
+
+struct roaring_int *roaring_int_and(struct roaring_int *dst, const struct roaring_int *a, const struct roaring_int *b)
+{
+	return roaring_int_op(dst, a, b, bitset_int_op_and);
+}
+
+struct roaring_int *roaring_int_or(struct roaring_int *dst, const struct roaring_int *a, const struct roaring_int *b)
+{
+	return roaring_int_op(dst, a, b, bitset_int_op_or);
+}
+
+struct roaring_int *roaring_int_xor(struct roaring_int *dst, const struct roaring_int *a, const struct roaring_int *b)
+{
+	return roaring_int_op(dst, a, b, bitset_int_op_xor);
+}
+
+struct roaring_int *roaring_int_andnot(struct roaring_int *dst, const struct roaring_int *a, const struct roaring_int *b)
+{
+	return roaring_int_op(dst, a, b, bitset_int_op_andnot);
+}
+
+/* The number of elements less than or equal to value is returned. */
+size_t roaring_int_rank(const struct roaring_int *set, int value)
+{
+	uint16_t key = (uint32_t) value >> 16;
+	size_t index;
+	bool present = roaring_int_search(set, key, &index);
+
+	size_t rank = 0;
+	for (size_t i = 0; i < index; i++) {
+		rank += set->containers[i].cardinality;
+	}
+	if (present) rank += roaring_int_container_rank(set->containers + index, (uint32_t) value & 0xffff);
+	return rank;
+}
+
+/* The element with the given rank, counted from zero in increasing order, is written to value.
+ * The bool return value is false if rank is not less than the cardinality.
+ */
+bool roaring_int_select(const struct roaring_int *set, size_t rank, int *value)
+{
+	for (size_t i = 0; i < set->size; i++) {
+		const struct roaring_container_int *c = set->containers + i;
+		if (rank < c->cardinality) {
+			*value = (int) ((uint32_t) c->key << 16 | roaring_int_container_select(c, (uint32_t) rank));
+			return true;
+		}
+		rank -= c->cardinality;
+	}
+	return false;
+}
+
+/* Containers are converted to run containers where that saves memory. This pays off for sets with
+ * long ranges of consecutive elements.
+ */
+void roaring_int_run_optimize(struct roaring_int *set)
+{
+	for (size_t i = 0; i < set->size; i++) {
+		roaring_int_container_run_optimize(set->containers + i);
+	}
+}
+
+/* The elements are iterated in increasing order. The set must not be modified during iteration. */
+void roaring_int_iter_init(struct roaring_iter_int *iter, const struct roaring_int *set)
+{
+	iter->set = set;
+	iter->container = 0;
+	iter->index = 0;
+	iter->offset = 0;
+	iter->bits = set->size > 0 && set->containers[0].kind == roaring_int_bitmap ? set->containers[0].data.bitmap[0] : 0;
+}
+
+/* The next element is written to value. The bool return value is false at the end of the set. */
+bool roaring_int_iter_next(struct roaring_iter_int *iter, int *value)
+{
+	while (iter->container < iter->set->size) {
+		const struct roaring_container_int *c = iter->set->containers + iter->container;
+		uint32_t high = (uint32_t) c->key << 16;
+		switch (c->kind) {
+		case roaring_int_array:
+			if (iter->index < c->size) {
+				*value = (int) (high | c->data.array[iter->index++]);
+				return true;
+			}
+			break;
+		case roaring_int_bitmap:
+			while (iter->bits == 0 && iter->index + 1 < ROARING_BITMAP_WORDS) {
+				iter->bits = c->data.bitmap[++iter->index];
+			}
+			if (iter->bits != 0) {
+				*value = (int) (high | (64 * iter->index + bitset_int_ctz64(iter->bits)));
+				iter->bits &= iter->bits - 1;
+				return true;
+			}
+			break;
+		default:
+			if (iter->index < c->size) {
+				*value = (int) (high | (c->data.runs[2 * iter->index] + iter->offset));
+				if (iter->offset == c->data.runs[2 * iter->index + 1]) {
+					iter->index++;
+					iter->offset = 0;
+				} else {
+					iter->offset++;
+				}
+				return true;
+			}
+			break;
+		}
+
+		iter->container++;
+		iter->index = 0;
+		iter->offset = 0;
+		if (iter->container < iter->set->size && iter->set->containers[iter->container].kind == roaring_int_bitmap) {
+			iter->bits = iter->set->containers[iter->container].data.bitmap[0];
+		}
+	}
+	return false;
+}
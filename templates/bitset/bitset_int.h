@@ -0,0 +1,95 @@
+/* This file is generated by the cgen program, https://github.com/morten-krogh/cgen. The cgen program is released under the MIT license.*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+enum bitset_int_simd {
+	bitset_int_simd_scalar,
+	bitset_int_simd_sse2,
+	bitset_int_simd_avx2
+};
+
+/* Only the first size words are in use. */
+struct bitset_int {
+	uint64_t *words;
+	size_t size;
+	size_t capacity;
+};
+
+struct bitset_iter_int {
+	const struct bitset_int *set;
+	size_t word;
+	uint64_t bits;
+};
+
+enum roaring_kind_int {
+	roaring_int_array,
+	roaring_int_bitmap,
+	roaring_int_run
+};
+
+/* size is the number of values in an array, the number of runs in a run container and 1024 in a
+ * bitmap. A run is stored as two values, the start and the length minus one.
+ */
+struct roaring_container_int {
+	uint16_t key;
+	uint8_t kind;
+	uint32_t cardinality;
+	uint32_t size;
+	uint32_t capacity;
+	union {
+		uint16_t *array;
+		uint16_t *runs;
+		uint64_t *bitmap;
+	} data;
+};
+
+struct roaring_int {
+	struct roaring_container_int *containers;
+	size_t size;
+	size_t capacity;
+};
+
+struct roaring_iter_int {
+	const struct roaring_int *set;
+	size_t container;
+	uint32_t index;
+	uint32_t offset;
+	uint64_t bits;
+};
+
+enum bitset_int_simd bitset_int_simd_level(void);
+enum bitset_int_simd bitset_int_set_simd_level(enum bitset_int_simd level);
+
+struct bitset_int *bitset_int_init(struct bitset_int *set);
+void bitset_int_free(struct bitset_int *set);
+bool bitset_int_add(struct bitset_int *set, int value);
+bool bitset_int_remove(struct bitset_int *set, int value);
+bool bitset_int_contains(const struct bitset_int *set, int value);
+size_t bitset_int_cardinality(const struct bitset_int *set);
+struct bitset_int *bitset_int_and(struct bitset_int *dst, const struct bitset_int *a, const struct bitset_int *b);
+struct bitset_int *bitset_int_or(struct bitset_int *dst, const struct bitset_int *a, const struct bitset_int *b);
+struct bitset_int *bitset_int_xor(struct bitset_int *dst, const struct bitset_int *a, const struct bitset_int *b);
+struct bitset_int *bitset_int_andnot(struct bitset_int *dst, const struct bitset_int *a, const struct bitset_int *b);
+size_t bitset_int_rank(const struct bitset_int *set, int value);
+bool bitset_int_select(const struct bitset_int *set, size_t rank, int *value);
+void bitset_int_iter_init(struct bitset_iter_int *iter, const struct bitset_int *set);
+bool bitset_int_iter_next(struct bitset_iter_int *iter, int *value);
+
+struct roaring_int *roaring_int_init(struct roaring_int *set);
+void roaring_int_free(struct roaring_int *set);
+bool roaring_int_add(struct roaring_int *set, int value);
+bool roaring_int_remove(struct roaring_int *set, int value);
+bool roaring_int_contains(const struct roaring_int *set, int value);
+size_t roaring_int_cardinality(const struct roaring_int *set);
+size_t roaring_int_size_in_bytes(const struct roaring_int *set);
+struct roaring_int *roaring_int_and(struct roaring_int *dst, const struct roaring_int *a, const struct roaring_int *b);
+struct roaring_int *roaring_int_or(struct roaring_int *dst, const struct roaring_int *a, const struct roaring_int *b);
+struct roaring_int *roaring_int_xor(struct roaring_int *dst, const struct roaring_int *a, const struct roaring_int *b);
+struct roaring_int *roaring_int_andnot(struct roaring_int *dst, const struct roaring_int *a, const struct roaring_int *b);
+size_t roaring_int_rank(const struct roaring_int *set, int value);
+bool roaring_int_select(const struct roaring_int *set, size_t rank, int *value);
+void roaring_int_run_optimize(struct roaring_int *set);
+void roaring_int_iter_init(struct roaring_iter_int *iter, const struct roaring_int *set);
+bool roaring_int_iter_next(struct roaring_iter_int *iter, int *value);
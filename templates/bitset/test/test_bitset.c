@@ -0,0 +1,275 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include "bitset_int.h"
+
+/* The dense and roaring bitsets are compared with a bool array over DOMAIN values. The domain
+ * spans five roaring containers which are filled sparsely, densely, with long runs and not at all,
+ * so that all container kinds meet each other in the set operations.
+ */
+
+#define DOMAIN (5 * 65536)
+
+void fill(bool *ref, int pattern)
+{
+	memset(ref, 0, DOMAIN);
+	for (int v = 0; v < DOMAIN; v++) {
+		int container = v / 65536;
+		switch ((container + pattern) % 4) {
+		case 0: ref[v] = rand() % 100 == 0; break;
+		case 1: ref[v] = rand() % 3 != 0; break;
+		case 2: ref[v] = (v / 1000) % 2 == 0; break;
+		case 3: break;
+		}
+	}
+}
+
+void check_dense(const struct bitset_int *set, const bool *ref)
+{
+	size_t cardinality = 0;
+	for (int v = 0; v < DOMAIN; v++) {
+		assert(bitset_int_contains(set, v) == ref[v]);
+		cardinality += ref[v];
+	}
+	assert(bitset_int_cardinality(set) == cardinality);
+
+	struct bitset_iter_int iter;
+	bitset_int_iter_init(&iter, set);
+	size_t rank = 0;
+	int value;
+	for (int v = 0; v < DOMAIN; v++) {
+		if (!ref[v]) continue;
+		assert(bitset_int_iter_next(&iter, &value) && value == v);
+		if (rank % 97 == 0) {
+			int selected;
+			assert(bitset_int_select(set, rank, &selected) && selected == v);
+		}
+		rank++;
+		if (rank % 89 == 0) assert(bitset_int_rank(set, v) == rank);
+	}
+	assert(!bitset_int_iter_next(&iter, &value));
+	assert(!bitset_int_select(set, cardinality, &value));
+	assert(bitset_int_rank(set, DOMAIN + 100) == cardinality);
+}
+
+void check_roaring(const struct roaring_int *set, const bool *ref)
+{
+	size_t cardinality = 0;
+	for (int v = 0; v < DOMAIN; v++) {
+		assert(roaring_int_contains(set, v) == ref[v]);
+		cardinality += ref[v];
+	}
+	assert(roaring_int_cardinality(set) == cardinality);
+
+	struct roaring_iter_int iter;
+	roaring_int_iter_init(&iter, set);
+	size_t rank = 0;
+	int value;
+	for (int v = 0; v < DOMAIN; v++) {
+		if (!ref[v]) continue;
+		assert(roaring_int_iter_next(&iter, &value) && value == v);
+		if (rank % 97 == 0) {
+			int selected;
+			assert(roaring_int_select(set, rank, &selected) && selected == v);
+		}
+		rank++;
+		if (rank % 89 == 0) assert(roaring_int_rank(set, v) == rank);
+	}
+	assert(!roaring_int_iter_next(&iter, &value));
+	assert(!roaring_int_select(set, cardinality, &value));
+	assert(roaring_int_rank(set, DOMAIN + 100) == cardinality);
+}
+
+void build(const bool *ref, struct bitset_int *dense, struct roaring_int *roaring)
+{
+	bitset_int_init(dense);
+	roaring_int_init(roaring);
+	for (int v = 0; v < DOMAIN; v++) {
+		if (!ref[v]) continue;
+		assert(!bitset_int_add(dense, v));
+		assert(!roaring_int_add(roaring, v));
+	}
+}
+
+void test_ops(int pattern_a, int pattern_b, bool optimize)
+{
+	static bool ref_a[DOMAIN];
+	static bool ref_b[DOMAIN];
+	static bool ref[DOMAIN];
+	fill(ref_a, pattern_a);
+	fill(ref_b, pattern_b);
+
+	struct bitset_int dense_a, dense_b, dense;
+	struct roaring_int roaring_a, roaring_b, roaring;
+	build(ref_a, &dense_a, &roaring_a);
+	build(ref_b, &dense_b, &roaring_b);
+	if (optimize) {
+		roaring_int_run_optimize(&roaring_a);
+		roaring_int_run_optimize(&roaring_b);
+	}
+	check_roaring(&roaring_a, ref_a);
+	check_roaring(&roaring_b, ref_b);
+	bitset_int_init(&dense);
+	roaring_int_init(&roaring);
+
+	for (int v = 0; v < DOMAIN; v++) ref[v] = ref_a[v] && ref_b[v];
+	assert(bitset_int_and(&dense, &dense_a, &dense_b) == &dense);
+	assert(roaring_int_and(&roaring, &roaring_a, &roaring_b) == &roaring);
+	check_dense(&dense, ref);
+	check_roaring(&roaring, ref);
+
+	for (int v = 0; v < DOMAIN; v++) ref[v] = ref_a[v] || ref_b[v];
+	bitset_int_or(&dense, &dense_a, &dense_b);
+	roaring_int_or(&roaring, &roaring_a, &roaring_b);
+	check_dense(&dense, ref);
+	check_roaring(&roaring, ref);
+
+	for (int v = 0; v < DOMAIN; v++) ref[v] = ref_a[v] != ref_b[v];
+	bitset_int_xor(&dense, &dense_a, &dense_b);
+	roaring_int_xor(&roaring, &roaring_a, &roaring_b);
+	check_dense(&dense, ref);
+	check_roaring(&roaring, ref);
+
+	for (int v = 0; v < DOMAIN; v++) ref[v] = ref_a[v] && !ref_b[v];
+	bitset_int_andnot(&dense, &dense_a, &dense_b);
+	roaring_int_andnot(&roaring, &roaring_a, &roaring_b);
+	check_dense(&dense, ref);
+	check_roaring(&roaring, ref);
+
+	/* In place */
+	bitset_int_and(&dense_a, &dense_a, &dense_b);
+	assert(roaring_int_and(&roaring_a, &roaring_a, &roaring_b) == &roaring_a);
+	for (int v = 0; v < DOMAIN; v++) ref[v] = ref_a[v] && ref_b[v];
+	check_dense(&dense_a, ref);
+	check_roaring(&roaring_a, ref);
+
+	assert(roaring_int_or(&roaring_b, &roaring_a, &roaring_b) == &roaring_b);
+	check_roaring(&roaring_b, ref_b);
+
+	bitset_int_free(&dense_a);
+	bitset_int_free(&dense_b);
+	bitset_int_free(&dense);
+	roaring_int_free(&roaring_a);
+	roaring_int_free(&roaring_b);
+	roaring_int_free(&roaring);
+}
+
+/* Elements are added and removed at random so that containers change between array and bitmap,
+ * and run containers are modified.
+ */
+void test_add_remove(void)
+{
+	static bool ref[DOMAIN];
+	fill(ref, 2);
+	struct bitset_int dense;
+	struct roaring_int roaring;
+	build(ref, &dense, &roaring);
+	roaring_int_run_optimize(&roaring);
+
+	for (int n = 0; n < 200000; n++) {
+		int v = rand() % DOMAIN;
+		if (rand() % 2) {
+			assert(bitset_int_add(&dense, v) == ref[v]);
+			assert(roaring_int_add(&roaring, v) == ref[v]);
+			ref[v] = true;
+		} else {
+			assert(bitset_int_remove(&dense, v) == ref[v]);
+			assert(roaring_int_remove(&roaring, v) == ref[v]);
+			ref[v] = false;
+		}
+		if (n % 50000 == 0) roaring_int_run_optimize(&roaring);
+	}
+	check_dense(&dense, ref);
+	check_roaring(&roaring, ref);
+
+	for (int v = 0; v < DOMAIN; v++) {
+		assert(roaring_int_remove(&roaring, v) == ref[v]);
+	}
+	assert(roaring.size == 0);
+	assert(roaring_int_cardinality(&roaring) == 0);
+
+	bitset_int_free(&dense);
+	roaring_int_free(&roaring);
+}
+
+void test_size(void)
+{
+	struct roaring_int roaring;
+	roaring_int_init(&roaring);
+	for (int v = 1000000; v < 2000000; v++) {
+		roaring_int_add(&roaring, v);
+	}
+	size_t bitmap_bytes = roaring_int_size_in_bytes(&roaring);
+	roaring_int_run_optimize(&roaring);
+	assert(roaring_int_size_in_bytes(&roaring) < bitmap_bytes / 100);
+	assert(roaring_int_cardinality(&roaring) == 1000000);
+	assert(roaring_int_rank(&roaring, 1500000) == 500001);
+	int value;
+	assert(roaring_int_select(&roaring, 700000, &value) && value == 1700000);
+	roaring_int_free(&roaring);
+}
+
+/* A selective and of array containers only keeps memory for the values in the result. Two arrays
+ * are merged and an array and a bitmap are filtered.
+ */
+void test_selective_size(void)
+{
+	struct roaring_int even, odd, wide, result;
+	roaring_int_init(&even);
+	roaring_int_init(&odd);
+	roaring_int_init(&wide);
+	roaring_int_init(&result);
+	for (int key = 0; key < 100; key++) {
+		int base = key * 65536;
+		for (int i = 0; i < 4000; i++) {
+			roaring_int_add(&even, base + 2 * i);
+			roaring_int_add(&odd, base + 2 * i + 1);
+		}
+		roaring_int_add(&odd, base);
+		for (int i = 0; i < 5000; i++) {
+			roaring_int_add(&wide, base + 8000 + i);
+		}
+		roaring_int_add(&wide, base);
+	}
+
+	assert(roaring_int_and(&result, &even, &odd) == &result);
+	assert(roaring_int_cardinality(&result) == 100);
+	assert(roaring_int_size_in_bytes(&result) == result.capacity * sizeof(struct roaring_container_int) + 100 * sizeof(uint16_t));
+
+	assert(roaring_int_and(&result, &even, &wide) == &result);
+	assert(roaring_int_cardinality(&result) == 100);
+	assert(roaring_int_size_in_bytes(&result) == result.capacity * sizeof(struct roaring_container_int) + 100 * sizeof(uint16_t));
+
+	assert(roaring_int_andnot(&result, &even, &even) == &result);
+	assert(result.size == 0);
+
+	roaring_int_free(&even);
+	roaring_int_free(&odd);
+	roaring_int_free(&wide);
+	roaring_int_free(&result);
+}
+
+int main(void)
+{
+	const char *level_names[] = {"scalar", "sse2", "avx2"};
+
+	for (int level = bitset_int_simd_scalar; level <= bitset_int_simd_avx2; level++) {
+		enum bitset_int_simd used = bitset_int_set_simd_level(level);
+		printf("testing simd level %s\n", level_names[used]);
+
+		srand(level);
+		for (int pattern_a = 0; pattern_a < 4; pattern_a++) {
+			for (int pattern_b = 0; pattern_b < 4; pattern_b++) {
+				test_ops(pattern_a, pattern_b, (pattern_a + pattern_b) % 2);
+			}
+		}
+		test_add_remove();
+		test_size();
+		test_selective_size();
+	}
+
+	printf("tests ran succesfully\n");
+}
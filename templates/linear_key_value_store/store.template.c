@@ -6,6 +6,9 @@
  * minimal memory.  This simple key-value store is not well suited for insertion oand deletions in
  * very large data sets.
  *
+ * The key order is exposed through lower and upper bounds, ranges of tuples, deletion of a range of
+ * keys with a single move, and lookup of a sorted batch of keys in one pass over the store.
+ *
  *
  * There are three template parameters: NAME, KEY_TYPE, and VALUE_TYPE.
  *
@@ -32,11 +35,24 @@ struct kv_store_NAME {
 	size_t capacity;
 };
 
+/* A range of tuples in key order. next is the next tuple to visit and end is one past the last. */
+struct kv_range_NAME {
+	struct kv_tuple_NAME *next;
+	struct kv_tuple_NAME *end;
+};
+
 struct kv_store_NAME *kv_store_NAME_init(struct kv_store_NAME *store, int (*compar)(KEY_TYPE key1, KEY_TYPE key2));
 void kv_store_NAME_free(struct kv_store_NAME *store);
 VALUE_TYPE *kv_store_NAME_get(struct kv_store_NAME *store, KEY_TYPE key);
 bool kv_store_NAME_put(struct kv_store_NAME *store, KEY_TYPE key, VALUE_TYPE value);
 bool kv_store_NAME_delete(struct kv_store_NAME *store, KEY_TYPE key);
+size_t kv_store_NAME_lower_bound(struct kv_store_NAME *store, KEY_TYPE key);
+size_t kv_store_NAME_upper_bound(struct kv_store_NAME *store, KEY_TYPE key);
+struct kv_range_NAME *kv_store_NAME_range(struct kv_store_NAME *store, KEY_TYPE low, KEY_TYPE high, struct kv_range_NAME *range);
+struct kv_range_NAME *kv_store_NAME_range_all(struct kv_store_NAME *store, struct kv_range_NAME *range);
+struct kv_tuple_NAME *kv_range_NAME_next(struct kv_range_NAME *range);
+size_t kv_store_NAME_delete_range(struct kv_store_NAME *store, KEY_TYPE low, KEY_TYPE high);
+size_t kv_store_NAME_get_batch(struct kv_store_NAME *store, const KEY_TYPE *keys, size_t nkeys, VALUE_TYPE **values);
 // cgen source
 
 #include <stdlib.h>
@@ -135,22 +151,144 @@ bool kv_store_NAME_put(struct kv_store_NAME *store, KEY_TYPE key, VALUE_TYPE val
 /* The value is deleted for the key. The bool return value is true if the key was present and false
  * if the key was absent.
  */
-
-#include<stdio.h> // REMOVE
-
 bool kv_store_NAME_delete(struct kv_store_NAME *store, KEY_TYPE key)
 {
 	ptrdiff_t lower;
 	ptrdiff_t upper;
 	kv_store_NAME_search(store, key, &lower, &upper);
-	printf("lower = %zu, upper = %zu, sizeof = %zu\n", lower, upper, sizeof(struct kv_tuple_NAME));
 
-	
 	if (lower == upper) {
-		memcpy(store->data + lower, store->data + lower + 1, (store->size - lower - 1) * sizeof(struct kv_tuple_NAME));
+		memmove(store->data + lower, store->data + lower + 1, (store->size - lower - 1) * sizeof(struct kv_tuple_NAME));
 		store->size--;
 		return true;
 	} else {
 		return false;
 	}
 }
+
+/* The index of the first key in [begin, end) that is not less than key, or end if there is none.
+ * The keys before begin must be less than key.
+ */
+static size_t kv_store_NAME_lower_bound_in(struct kv_store_NAME *store, KEY_TYPE key, size_t begin, size_t end)
+{
+	while (begin < end) {
+		size_t middle = begin + (end - begin) / 2;
+		if (store->compar(store->data[middle].key, key) < 0) {
+			begin = middle + 1;
+		} else {
+			end = middle;
+		}
+	}
+	return begin;
+}
+
+/* The index of the first key that is not less than key is returned. size is returned if all keys
+ * are less than key.
+ */
+size_t kv_store_NAME_lower_bound(struct kv_store_NAME *store, KEY_TYPE key)
+{
+	return kv_store_NAME_lower_bound_in(store, key, 0, store->size);
+}
+
+/* The index of the first key that is greater than key is returned. size is returned if no key is
+ * greater than key.
+ */
+size_t kv_store_NAME_upper_bound(struct kv_store_NAME *store, KEY_TYPE key)
+{
+	size_t begin = 0;
+	size_t end = store->size;
+	while (begin < end) {
+		size_t middle = begin + (end - begin) / 2;
+		if (store->compar(store->data[middle].key, key) <= 0) {
+			begin = middle + 1;
+		} else {
+			end = middle;
+		}
+	}
+	return begin;
+}
+
+/* The range is set to the tuples with low <= key < high in key order. The range is invalidated by
+ * put and delete. range is returned.
+ */
+struct kv_range_NAME *kv_store_NAME_range(struct kv_store_NAME *store, KEY_TYPE low, KEY_TYPE high, struct kv_range_NAME *range)
+{
+	size_t begin = kv_store_NAME_lower_bound(store, low);
+	size_t end = begin;
+	if (store->compar(low, high) < 0) {
+		end = kv_store_NAME_lower_bound_in(store, high, begin, store->size);
+	}
+	range->next = store->data + begin;
+	range->end = store->data + end;
+
+	return range;
+}
+
+/* The range is set to all tuples in key order. range is returned. */
+struct kv_range_NAME *kv_store_NAME_range_all(struct kv_store_NAME *store, struct kv_range_NAME *range)
+{
+	range->next = store->data;
+	range->end = store->data + store->size;
+
+	return range;
+}
+
+/* The next tuple of the range is returned. NULL is returned at the end of the range. */
+struct kv_tuple_NAME *kv_range_NAME_next(struct kv_range_NAME *range)
+{
+	if (range->next == range->end) return NULL;
+	return range->next++;
+}
+
+/* The tuples with low <= key < high are deleted with a single move of the tuples above them. The
+ * number of deleted tuples is returned.
+ */
+size_t kv_store_NAME_delete_range(struct kv_store_NAME *store, KEY_TYPE low, KEY_TYPE high)
+{
+	if (store->compar(low, high) >= 0) return 0;
+
+	size_t begin = kv_store_NAME_lower_bound(store, low);
+	size_t end = kv_store_NAME_lower_bound_in(store, high, begin, store->size);
+	if (end > begin) {
+		memmove(store->data + begin, store->data + end, (store->size - end) * sizeof(struct kv_tuple_NAME));
+		store->size -= end - begin;
+	}
+
+	return end - begin;
+}
+
+/* The values of nkeys keys are looked up. The keys must be sorted in increasing order according to
+ * compar. values[i] is set to a pointer to the value of keys[i], or NULL if keys[i] is absent. The
+ * number of keys found is returned.
+ *
+ * The store is traversed once from left to right. Each key is located by galloping from the
+ * position of the previous key: the distance is doubled until a key that is not less than the key
+ * is passed, followed by a binary search in the last interval. The complexity is O(M log(N / M))
+ * for M keys in a store of size N, which is at most O(N + M).
+ */
+size_t kv_store_NAME_get_batch(struct kv_store_NAME *store, const KEY_TYPE *keys, size_t nkeys, VALUE_TYPE **values)
+{
+	size_t found = 0;
+	size_t position = 0;
+	for (size_t i = 0; i < nkeys; i++) {
+		size_t begin = position;
+		size_t probe = position;
+		size_t step = 1;
+		while (probe < store->size && store->compar(store->data[probe].key, keys[i]) < 0) {
+			begin = probe + 1;
+			probe += step;
+			step *= 2;
+		}
+		size_t end = probe < store->size ? probe : store->size;
+		position = kv_store_NAME_lower_bound_in(store, keys[i], begin, end);
+
+		if (position < store->size && store->compar(store->data[position].key, keys[i]) == 0) {
+			values[i] = &store->data[position].value;
+			found++;
+		} else {
+			values[i] = NULL;
+		}
+	}
+
+	return found;
+}
@@ -98,22 +98,144 @@ bool kv_store_int_int_put(struct kv_store_int_int *store, int key, int value)
 /* The value is deleted for the key. The bool return value is true if the key was present and false
  * if the key was absent.
  */
-
-#include<stdio.h> // REMOVE
-
 bool kv_store_int_int_delete(struct kv_store_int_int *store, int key)
 {
 	ptrdiff_t lower;
 	ptrdiff_t upper;
 	kv_store_int_int_search(store, key, &lower, &upper);
-	printf("lower = %zu, upper = %zu, sizeof = %zu\n", lower, upper, sizeof(struct kv_tuple_int_int));
 
-	
 	if (lower == upper) {
-		memcpy(store->data + lower, store->data + lower + 1, (store->size - lower - 1) * sizeof(struct kv_tuple_int_int));
+		memmove(store->data + lower, store->data + lower + 1, (store->size - lower - 1) * sizeof(struct kv_tuple_int_int));
 		store->size--;
 		return true;
 	} else {
 		return false;
 	}
 }
+
+/* The index of the first key in [begin, end) that is not less than key, or end if there is none.
+ * The keys before begin must be less than key.
+ */
+static size_t kv_store_int_int_lower_bound_in(struct kv_store_int_int *store, int key, size_t begin, size_t end)
+{
+	while (begin < end) {
+		size_t middle = begin + (end - begin) / 2;
+		if (store->compar(store->data[middle].key, key) < 0) {
+			begin = middle + 1;
+		} else {
+			end = middle;
+		}
+	}
+	return begin;
+}
+
+/* The index of the first key that is not less than key is returned. size is returned if all keys
+ * are less than key.
+ */
+size_t kv_store_int_int_lower_bound(struct kv_store_int_int *store, int key)
+{
+	return kv_store_int_int_lower_bound_in(store, key, 0, store->size);
+}
+
+/* The index of the first key that is greater than key is returned. size is returned if no key is
+ * greater than key.
+ */
+size_t kv_store_int_int_upper_bound(struct kv_store_int_int *store, int key)
+{
+	size_t begin = 0;
+	size_t end = store->size;
+	while (begin < end) {
+		size_t middle = begin + (end - begin) / 2;
+		if (store->compar(store->data[middle].key, key) <= 0) {
+			begin = middle + 1;
+		} else {
+			end = middle;
+		}
+	}
+	return begin;
+}
+
+/* The range is set to the tuples with low <= key < high in key order. The range is invalidated by
+ * put and delete. range is returned.
+ */
+struct kv_range_int_int *kv_store_int_int_range(struct kv_store_int_int *store, int low, int high, struct kv_range_int_int *range)
+{
+	size_t begin = kv_store_int_int_lower_bound(store, low);
+	size_t end = begin;
+	if (store->compar(low, high) < 0) {
+		end = kv_store_int_int_lower_bound_in(store, high, begin, store->size);
+	}
+	range->next = store->data + begin;
+	range->end = store->data + end;
+
+	return range;
+}
+
+/* The range is set to all tuples in key order. range is returned. */
+struct kv_range_int_int *kv_store_int_int_range_all(struct kv_store_int_int *store, struct kv_range_int_int *range)
+{
+	range->next = store->data;
+	range->end = store->data + store->size;
+
+	return range;
+}
+
+/* The next tuple of the range is returned. NULL is returned at the end of the range. */
+struct kv_tuple_int_int *kv_range_int_int_next(struct kv_range_int_int *range)
+{
+	if (range->next == range->end) return NULL;
+	return range->next++;
+}
+
+/* The tuples with low <= key < high are deleted with a single move of the tuples above them. The
+ * number of deleted tuples is returned.
+ */
+size_t kv_store_int_int_delete_range(struct kv_store_int_int *store, int low, int high)
+{
+	if (store->compar(low, high) >= 0) return 0;
+
+	size_t begin = kv_store_int_int_lower_bound(store, low);
+	size_t end = kv_store_int_int_lower_bound_in(store, high, begin, store->size);
+	if (end > begin) {
+		memmove(store->data + begin, store->data + end, (store->size - end) * sizeof(struct kv_tuple_int_int));
+		store->size -= end - begin;
+	}
+
+	return end - begin;
+}
+
+/* The values of nkeys keys are looked up. The keys must be sorted in increasing order according to
+ * compar. values[i] is set to a pointer to the value of keys[i], or NULL if keys[i] is absent. The
+ * number of keys found is returned.
+ *
+ * The store is traversed once from left to right. Each key is located by galloping from the
+ * position of the previous key: the distance is doubled until a key that is not less than the key
+ * is passed, followed by a binary search in the last interval. The complexity is O(M log(N / M))
+ * for M keys in a store of size N, which is at most O(N + M).
+ */
+size_t kv_store_int_int_get_batch(struct kv_store_int_int *store, const int *keys, size_t nkeys, int **values)
+{
+	size_t found = 0;
+	size_t position = 0;
+	for (size_t i = 0; i < nkeys; i++) {
+		size_t begin = position;
+		size_t probe = position;
+		size_t step = 1;
+		while (probe < store->size && store->compar(store->data[probe].key, keys[i]) < 0) {
+			begin = probe + 1;
+			probe += step;
+			step *= 2;
+		}
+		size_t end = probe < store->size ? probe : store->size;
+		position = kv_store_int_int_lower_bound_in(store, keys[i], begin, end);
+
+		if (position < store->size && store->compar(store->data[position].key, keys[i]) == 0) {
+			values[i] = &store->data[position].value;
+			found++;
+		} else {
+			values[i] = NULL;
+		}
+	}
+
+	return found;
+}
@@ -15,8 +15,21 @@ struct kv_store_int_int {
 	size_t capacity;
 };
 
+/* A range of tuples in key order. next is the next tuple to visit and end is one past the last. */
+struct kv_range_int_int {
+	struct kv_tuple_int_int *next;
+	struct kv_tuple_int_int *end;
+};
+
 struct kv_store_int_int *kv_store_int_int_init(struct kv_store_int_int *store, int (*compar)(int key1, int key2));
 void kv_store_int_int_free(struct kv_store_int_int *store);
 int *kv_store_int_int_get(struct kv_store_int_int *store, int key);
 bool kv_store_int_int_put(struct kv_store_int_int *store, int key, int value);
 bool kv_store_int_int_delete(struct kv_store_int_int *store, int key);
+size_t kv_store_int_int_lower_bound(struct kv_store_int_int *store, int key);
+size_t kv_store_int_int_upper_bound(struct kv_store_int_int *store, int key);
+struct kv_range_int_int *kv_store_int_int_range(struct kv_store_int_int *store, int low, int high, struct kv_range_int_int *range);
+struct kv_range_int_int *kv_store_int_int_range_all(struct kv_store_int_int *store, struct kv_range_int_int *range);
+struct kv_tuple_int_int *kv_range_int_int_next(struct kv_range_int_int *range);
+size_t kv_store_int_int_delete_range(struct kv_store_int_int *store, int low, int high);
+size_t kv_store_int_int_get_batch(struct kv_store_int_int *store, const int *keys, size_t nkeys, int **values);
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
 
 #include "store_int_int.h"
@@ -18,6 +19,84 @@ void print_store(struct kv_store_int_int *store)
 	}
 }
 
+/* The store holds the keys 0, 2, 4, ..., 2 * (N - 1) with value = 10 * key. */
+void test_range_and_batch(void)
+{
+	struct kv_store_int_int store;
+	kv_store_int_int_init(&store, compar);
+
+	const int N = 10000;
+	for (int i = 0; i < N; i++) {
+		kv_store_int_int_put(&store, 2 * i, 20 * i);
+	}
+
+	assert(kv_store_int_int_lower_bound(&store, -5) == 0);
+	assert(kv_store_int_int_lower_bound(&store, 10) == 5);
+	assert(kv_store_int_int_lower_bound(&store, 11) == 6);
+	assert(kv_store_int_int_upper_bound(&store, 10) == 6);
+	assert(kv_store_int_int_upper_bound(&store, 11) == 6);
+	assert(kv_store_int_int_lower_bound(&store, 2 * N) == N);
+	assert(kv_store_int_int_upper_bound(&store, 2 * N - 2) == N);
+
+	struct kv_range_int_int range;
+	struct kv_tuple_int_int *tuple;
+	int expected = 100;
+	kv_store_int_int_range(&store, 99, 200, &range);
+	while ((tuple = kv_range_int_int_next(&range)) != NULL) {
+		assert(tuple->key == expected);
+		assert(tuple->value == 10 * expected);
+		expected += 2;
+	}
+	assert(expected == 200);
+
+	kv_store_int_int_range(&store, 200, 100, &range);
+	assert(kv_range_int_int_next(&range) == NULL);
+
+	size_t count = 0;
+	kv_store_int_int_range_all(&store, &range);
+	while ((tuple = kv_range_int_int_next(&range)) != NULL) {
+		assert(tuple->key == 2 * (int) count);
+		count++;
+	}
+	assert(count == N);
+
+	int keys[] = {-3, 0, 1, 2, 2, 3, 500, 501, 502, 19998, 19999, 30000};
+	const size_t nkeys = sizeof keys / sizeof keys[0];
+	int *values[sizeof keys / sizeof keys[0]];
+	assert(kv_store_int_int_get_batch(&store, keys, nkeys, values) == 6);
+	for (size_t i = 0; i < nkeys; i++) {
+		int *value = kv_store_int_int_get(&store, keys[i]);
+		assert(values[i] == value);
+	}
+
+	int *all_keys = malloc(2 * N * sizeof(int));
+	int **all_values = malloc(2 * N * sizeof(int *));
+	for (int i = 0; i < 2 * N; i++) {
+		all_keys[i] = i;
+	}
+	assert(kv_store_int_int_get_batch(&store, all_keys, 2 * N, all_values) == N);
+	for (int i = 0; i < 2 * N; i++) {
+		assert(i % 2 == 0 ? *all_values[i] == 10 * i : all_values[i] == NULL);
+	}
+	free(all_keys);
+	free(all_values);
+
+	assert(kv_store_int_int_delete_range(&store, 100, 100) == 0);
+	assert(kv_store_int_int_delete_range(&store, 99, 200) == 50);
+	assert(store.size == N - 50);
+	assert(kv_store_int_int_get(&store, 98) != NULL);
+	assert(kv_store_int_int_get(&store, 100) == NULL);
+	assert(kv_store_int_int_get(&store, 198) == NULL);
+	assert(*kv_store_int_int_get(&store, 200) == 2000);
+	assert(kv_store_int_int_delete_range(&store, 19000, 50000) == 500);
+	assert(kv_store_int_int_delete_range(&store, -10, 100) == 50);
+	assert(store.size == N - 600);
+	assert(store.data[0].key == 200);
+	assert(store.data[store.size - 1].key == 18998);
+
+	kv_store_int_int_free(&store);
+}
+
 int main(void)
 {
 	struct kv_store_int_int store;
@@ -63,6 +142,8 @@ int main(void)
 	assert(store.size == N + 2);	
 
 	kv_store_int_int_free(&store);
+
+	test_range_and_batch();
 	
 	printf("tests ran succesfully\n");
 
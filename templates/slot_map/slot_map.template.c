@@ -0,0 +1,181 @@
+/*
+ * This template creates a slot map. A slot map stores values densely in an expandable array and
+ * hands out integer handles to them. A handle stays valid until its value is removed, even though
+ * values move in the dense array when other values are inserted or removed. Insertion, removal and
+ * lookup by handle have O(1) complexity. Iteration over the values is a plain loop over the dense
+ * array data[0], ..., data[size - 1].
+ *
+ * Removal moves the last value of the dense array into the hole. Pointers into the dense array are
+ * hence invalidated by insertion and removal. Handles must be used to refer to values across
+ * insertions and removals.
+ *
+ * A handle consists of a 32 bit slot index and a 32 bit generation. The slot stores the position of
+ * the value in the dense array. The generation of a slot is odd while the slot is in use and is
+ * incremented when the slot is taken or freed. A handle of a removed value has an old generation and
+ * is rejected. The handle 0 is never valid. A slot can be reused 2^31 times before generations wrap
+ * around.
+ *
+ * There are two template parameters: NAME and TYPE.
+ *
+ * The typedef below is just to make the template file syntactically correct c. It is a cgen comment
+ * and will be ignored.
+ */
+
+typedef int TYPE;
+
+// cgen header
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* index is the position in the dense array of a used slot and the next free slot of a free slot */
+struct slot_NAME {
+	uint32_t index;
+	uint32_t generation;
+};
+
+/* slots has room for capacity slots of which nslots have been used. slot_of[i] is the slot of
+ * data[i].
+ */
+struct slot_map_NAME {
+	TYPE *data;
+	uint32_t *slot_of;
+	struct slot_NAME *slots;
+	size_t size;
+	size_t capacity;
+	size_t nslots;
+	uint32_t free_slot;
+};
+
+struct slot_map_NAME *slot_map_NAME_init(struct slot_map_NAME *map);
+void slot_map_NAME_free(struct slot_map_NAME *map);
+uint64_t slot_map_NAME_insert(struct slot_map_NAME *map, TYPE t);
+TYPE *slot_map_NAME_get(struct slot_map_NAME *map, uint64_t handle);
+bool slot_map_NAME_remove(struct slot_map_NAME *map, uint64_t handle);
+uint64_t slot_map_NAME_handle(const struct slot_map_NAME *map, size_t index);
+// cgen source
+
+#include <stdlib.h>
+
+#define SLOT_MAP_NONE UINT32_MAX
+
+struct slot_map_NAME *slot_map_NAME_init(struct slot_map_NAME *map)
+{
+	map->data = NULL;
+	map->slot_of = NULL;
+	map->slots = NULL;
+	map->size = 0;
+	map->capacity = 0;
+	map->nslots = 0;
+	map->free_slot = SLOT_MAP_NONE;
+
+	return map;
+}
+
+void slot_map_NAME_free(struct slot_map_NAME *map)
+{
+	free(map->data);
+	free(map->slot_of);
+	free(map->slots);
+}
+
+/* The dense array and the slots grow together since there are never more slots than the largest
+ * size of the dense array. The bool return value is false if memory could not be allocated.
+ */
+static bool slot_map_NAME_grow(struct slot_map_NAME *map)
+{
+	size_t new_capacity = 2 * map->capacity + 1;
+	if (new_capacity >= SLOT_MAP_NONE) new_capacity = SLOT_MAP_NONE - 1;
+	if (new_capacity <= map->capacity) return false;
+
+	TYPE *data = realloc(map->data, new_capacity * sizeof(TYPE));
+	if (data == NULL) return false;
+	map->data = data;
+
+	uint32_t *slot_of = realloc(map->slot_of, new_capacity * sizeof(uint32_t));
+	if (slot_of == NULL) return false;
+	map->slot_of = slot_of;
+
+	struct slot_NAME *slots = realloc(map->slots, new_capacity * sizeof(struct slot_NAME));
+	if (slots == NULL) return false;
+	map->slots = slots;
+
+	map->capacity = new_capacity;
+	return true;
+}
+
+static uint64_t slot_map_NAME_make_handle(uint32_t slot, uint32_t generation)
+{
+	return (uint64_t) generation << 32 | slot;
+}
+
+/* t is appended to the dense array. The returned handle refers to t until it is removed. 0 is
+ * returned if memory could not be allocated.
+ */
+uint64_t slot_map_NAME_insert(struct slot_map_NAME *map, TYPE t)
+{
+	if (map->size == map->capacity && !slot_map_NAME_grow(map)) return 0;
+
+	uint32_t slot = map->free_slot;
+	if (slot == SLOT_MAP_NONE) {
+		slot = (uint32_t) map->nslots;
+		map->slots[slot].generation = 0;
+		map->nslots++;
+	} else {
+		map->free_slot = map->slots[slot].index;
+	}
+
+	uint32_t index = (uint32_t) map->size;
+	map->slots[slot].index = index;
+	map->slots[slot].generation++;
+	map->slot_of[index] = slot;
+	map->data[index] = t;
+	map->size++;
+
+	return slot_map_NAME_make_handle(slot, map->slots[slot].generation);
+}
+
+/* A pointer to the value of handle is returned. NULL is returned if the value has been removed or
+ * the handle is invalid. The pointer is valid until the next insertion or removal.
+ */
+TYPE *slot_map_NAME_get(struct slot_map_NAME *map, uint64_t handle)
+{
+	uint32_t slot = (uint32_t) handle;
+	uint32_t generation = (uint32_t) (handle >> 32);
+	if (slot >= map->nslots || map->slots[slot].generation != generation || generation % 2 == 0) return NULL;
+	return map->data + map->slots[slot].index;
+}
+
+/* The value of handle is removed and the last value in the dense array takes its place. The bool
+ * return value is true if the value was present and false if it had been removed already or the
+ * handle is invalid.
+ */
+bool slot_map_NAME_remove(struct slot_map_NAME *map, uint64_t handle)
+{
+	uint32_t slot = (uint32_t) handle;
+	uint32_t generation = (uint32_t) (handle >> 32);
+	if (slot >= map->nslots || map->slots[slot].generation != generation || generation % 2 == 0) return false;
+
+	uint32_t index = map->slots[slot].index;
+	uint32_t last = (uint32_t) map->size - 1;
+	if (index != last) {
+		map->data[index] = map->data[last];
+		map->slot_of[index] = map->slot_of[last];
+		map->slots[map->slot_of[index]].index = index;
+	}
+	map->size--;
+
+	map->slots[slot].generation++;
+	map->slots[slot].index = map->free_slot;
+	map->free_slot = slot;
+
+	return true;
+}
+
+/* The handle of the value data[index] is returned. index must be less than size. */
+uint64_t slot_map_NAME_handle(const struct slot_map_NAME *map, size_t index)
+{
+	uint32_t slot = map->slot_of[index];
+	return slot_map_NAME_make_handle(slot, map->slots[slot].generation);
+}
@@ -0,0 +1,127 @@
+/* This file is generated by the cgen program, https://github.com/morten-krogh/cgen. The cgen program is released under the MIT license.*/
+
+#include "slot_map_int.h"
+
+#include <stdlib.h>
+
+#define SLOT_MAP_NONE UINT32_MAX
+
+struct slot_map_int *slot_map_int_init(struct slot_map_int *map)
+{
+	map->data = NULL;
+	map->slot_of = NULL;
+	map->slots = NULL;
+	map->size = 0;
+	map->capacity = 0;
+	map->nslots = 0;
+	map->free_slot = SLOT_MAP_NONE;
+
+	return map;
+}
+
+void slot_map_int_free(struct slot_map_int *map)
+{
+	free(map->data);
+	free(map->slot_of);
+	free(map->slots);
+}
+
+/* The dense array and the slots grow together since there are never more slots than the largest
+ * size of the dense array. The bool return value is false if memory could not be allocated.
+ */
+static bool slot_map_int_grow(struct slot_map_int *map)
+{
+	size_t new_capacity = 2 * map->capacity + 1;
+	if (new_capacity >= SLOT_MAP_NONE) new_capacity = SLOT_MAP_NONE - 1;
+	if (new_capacity <= map->capacity) return false;
+
+	int *data = realloc(map->data, new_capacity * sizeof(int));
+	if (data == NULL) return false;
+	map->data = data;
+
+	uint32_t *slot_of = realloc(map->slot_of, new_capacity * sizeof(uint32_t));
+	if (slot_of == NULL) return false;
+	map->slot_of = slot_of;
+
+	struct slot_int *slots = realloc(map->slots, new_capacity * sizeof(struct slot_int));
+	if (slots == NULL) return false;
+	map->slots = slots;
+
+	map->capacity = new_capacity;
+	return true;
+}
+
+static uint64_t slot_map_int_make_handle(uint32_t slot, uint32_t generation)
+{
+	return (uint64_t) generation << 32 | slot;
+}
+
+/* t is appended to the dense array. The returned handle refers to t until it is removed. 0 is
+ * returned if memory could not be allocated.
+ */
+uint64_t slot_map_int_insert(struct slot_map_int *map, int t)
+{
+	if (map->size == map->capacity && !slot_map_int_grow(map)) return 0;
+
+	uint32_t slot = map->free_slot;
+	if (slot == SLOT_MAP_NONE) {
+		slot = (uint32_t) map->nslots;
+		map->slots[slot].generation = 0;
+		map->nslots++;
+	} else {
+		map->free_slot = map->slots[slot].index;
+	}
+
+	uint32_t index = (uint32_t) map->size;
+	map->slots[slot].index = index;
+	map->slots[slot].generation++;
+	map->slot_of[index] = slot;
+	map->data[index] = t;
+	map->size++;
+
+	return slot_map_int_make_handle(slot, map->slots[slot].generation);
+}
+
+/* A pointer to the value of handle is returned. NULL is returned if the value has been removed or
+ * the handle is invalid. The pointer is valid until the next insertion or removal.
+ */
+int *slot_map_int_get(struct slot_map_int *map, uint64_t handle)
+{
+	uint32_t slot = (uint32_t) handle;
+	uint32_t generation = (uint32_t) (handle >> 32);
+	if (slot >= map->nslots || map->slots[slot].generation != generation || generation % 2 == 0) return NULL;
+	return map->data + map->slots[slot].index;
+}
+
+/* The value of handle is removed and the last value in the dense array takes its place. The bool
+ * return value is true if the value was present and false if it had been removed already or the
+ * handle is invalid.
+ */
+bool slot_map_int_remove(struct slot_map_int *map, uint64_t handle)
+{
+	uint32_t slot = (uint32_t) handle;
+	uint32_t generation = (uint32_t) (handle >> 32);
+	if (slot >= map->nslots || map->slots[slot].generation != generation || generation % 2 == 0) return false;
+
+	uint32_t index = map->slots[slot].index;
+	uint32_t last = (uint32_t) map->size - 1;
+	if (index != last) {
+		map->data[index] = map->data[last];
+		map->slot_of[index] = map->slot_of[last];
+		map->slots[map->slot_of[index]].index = index;
+	}
+	map->size--;
+
+	map->slots[slot].generation++;
+	map->slots[slot].index = map->free_slot;
+	map->free_slot = slot;
+
+	return true;
+}
+
+/* The handle of the value data[index] is returned. index must be less than size. */
+uint64_t slot_map_int_handle(const struct slot_map_int *map, size_t index)
+{
+	uint32_t slot = map->slot_of[index];
+	return slot_map_int_make_handle(slot, map->slots[slot].generation);
+}
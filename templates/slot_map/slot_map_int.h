@@ -0,0 +1,31 @@
+/* This file is generated by the cgen program, https://github.com/morten-krogh/cgen. The cgen program is released under the MIT license.*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* index is the position in the dense array of a used slot and the next free slot of a free slot */
+struct slot_int {
+	uint32_t index;
+	uint32_t generation;
+};
+
+/* slots has room for capacity slots of which nslots have been used. slot_of[i] is the slot of
+ * data[i].
+ */
+struct slot_map_int {
+	int *data;
+	uint32_t *slot_of;
+	struct slot_int *slots;
+	size_t size;
+	size_t capacity;
+	size_t nslots;
+	uint32_t free_slot;
+};
+
+struct slot_map_int *slot_map_int_init(struct slot_map_int *map);
+void slot_map_int_free(struct slot_map_int *map);
+uint64_t slot_map_int_insert(struct slot_map_int *map, int t);
+int *slot_map_int_get(struct slot_map_int *map, uint64_t handle);
+bool slot_map_int_remove(struct slot_map_int *map, uint64_t handle);
+uint64_t slot_map_int_handle(const struct slot_map_int *map, size_t index);
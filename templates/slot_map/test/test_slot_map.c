@@ -0,0 +1,79 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "slot_map_int.h"
+
+/* Values are inserted and removed at random. A plain array of handles and values is the
+ * reference. Removed handles are kept to check that they stay invalid when slots are reused.
+ */
+
+int main(void)
+{
+	struct slot_map_int map;
+	slot_map_int_init(&map);
+
+	assert(slot_map_int_get(&map, 0) == NULL);
+	assert(slot_map_int_remove(&map, 0) == false);
+
+	const int N = 100000;
+	uint64_t *handles = malloc(N * sizeof(uint64_t));
+	int *values = malloc(N * sizeof(int));
+	uint64_t *removed = malloc(N * sizeof(uint64_t));
+	size_t nhandles = 0;
+	size_t nremoved = 0;
+
+	for (int i = 0; i < N; i++) {
+		if (nhandles > 0 && rand() % 3 == 0) {
+			size_t k = rand() % nhandles;
+			assert(slot_map_int_remove(&map, handles[k]) == true);
+			assert(slot_map_int_remove(&map, handles[k]) == false);
+			assert(slot_map_int_get(&map, handles[k]) == NULL);
+			removed[nremoved++] = handles[k];
+			nhandles--;
+			handles[k] = handles[nhandles];
+			values[k] = values[nhandles];
+		} else {
+			uint64_t handle = slot_map_int_insert(&map, i);
+			assert(handle != 0);
+			handles[nhandles] = handle;
+			values[nhandles] = i;
+			nhandles++;
+		}
+		assert(map.size == nhandles);
+	}
+
+	for (size_t k = 0; k < nhandles; k++) {
+		int *value = slot_map_int_get(&map, handles[k]);
+		assert(value != NULL && *value == values[k]);
+	}
+
+	for (size_t k = 0; k < nremoved; k++) {
+		assert(slot_map_int_get(&map, removed[k]) == NULL);
+	}
+
+	long long sum = 0;
+	long long expected = 0;
+	for (size_t i = 0; i < map.size; i++) {
+		sum += map.data[i];
+		assert(*slot_map_int_get(&map, slot_map_int_handle(&map, i)) == map.data[i]);
+	}
+	for (size_t k = 0; k < nhandles; k++) {
+		expected += values[k];
+	}
+	assert(sum == expected);
+
+	while (map.size > 0) {
+		assert(slot_map_int_remove(&map, slot_map_int_handle(&map, 0)) == true);
+	}
+	for (size_t k = 0; k < nhandles; k++) {
+		assert(slot_map_int_get(&map, handles[k]) == NULL);
+	}
+
+	free(handles);
+	free(values);
+	free(removed);
+	slot_map_int_free(&map);
+
+	printf("tests ran succesfully\n");
+}
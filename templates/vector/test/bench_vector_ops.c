@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "vector_ops_int.h"
+#include "vector_ops_double.h"
+
+/* Every bulk operation is timed at every SIMD level supported by the cpu. The printed sink values
+ * keep the compiler from removing the calls.
+ */
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+static void report(const char *op, const char *level, size_t elements, double seconds)
+{
+	printf("%-12s %-7s %8.3f ms %8.2f Gelem/s\n", op, level, 1e3 * seconds, 1e-9 * elements / seconds);
+}
+
+int main(void)
+{
+	const char *level_names[] = {"scalar", "sse2", "avx2"};
+	const size_t N = 1 << 22;
+	const int R = 20;
+
+	struct vector_int ints;
+	struct vector_double doubles;
+	struct vector_int int_out;
+	struct vector_double double_out;
+	vector_int_init(&ints);
+	vector_double_init(&doubles);
+	vector_int_init(&int_out);
+	vector_double_init(&double_out);
+	for (size_t i = 0; i < N; i++) {
+		vector_int_append(&ints, rand() % 1000);
+		vector_double_append(&doubles, rand() % 1000);
+	}
+
+	size_t sink = 0;
+	double double_sink = 0;
+	for (int level = vector_int_simd_scalar; level <= vector_int_simd_avx2; level++) {
+		if ((int) vector_int_set_simd_level(level) != level) break;
+		vector_double_set_simd_level(level);
+		const char *name = level_names[level];
+		double start;
+		int result;
+		double double_result;
+
+		start = now();
+		for (int r = 0; r < R; r++) sink += vector_int_find(&ints, -1);
+		report("int find", name, R * N, now() - start);
+
+		start = now();
+		for (int r = 0; r < R; r++) sink += vector_int_count(&ints, r);
+		report("int count", name, R * N, now() - start);
+
+		start = now();
+		for (int r = 0; r < R; r++) sink += vector_int_min(&ints, &result) + result;
+		report("int min", name, R * N, now() - start);
+
+		start = now();
+		for (int r = 0; r < R; r++) sink += vector_int_sum(&ints);
+		report("int sum", name, R * N, now() - start);
+
+		start = now();
+		for (int r = 0; r < R; r++) {
+			int_out.size = 0;
+			sink += vector_int_filter(&int_out, &ints, 100, 300)->size;
+		}
+		report("int filter", name, R * N, now() - start);
+
+		start = now();
+		for (int r = 0; r < R; r++) vector_int_add_scalar(&ints, r % 2 ? 1 : -1);
+		report("int add", name, R * N, now() - start);
+
+		start = now();
+		for (int r = 0; r < R; r++) sink += vector_double_count(&doubles, r);
+		report("double count", name, R * N, now() - start);
+
+		start = now();
+		for (int r = 0; r < R; r++) double_sink += vector_double_max(&doubles, &double_result) + double_result;
+		report("double max", name, R * N, now() - start);
+
+		start = now();
+		for (int r = 0; r < R; r++) double_sink += vector_double_sum(&doubles);
+		report("double sum", name, R * N, now() - start);
+
+		start = now();
+		for (int r = 0; r < R; r++) {
+			double_out.size = 0;
+			sink += vector_double_filter(&double_out, &doubles, 100, 300)->size;
+		}
+		report("double filter", name, R * N, now() - start);
+
+		start = now();
+		for (int r = 0; r < R; r++) vector_double_mul_scalar(&doubles, r % 2 ? 2 : 0.5);
+		report("double mul", name, R * N, now() - start);
+	}
+
+	printf("sink = %zu %g\n", sink, double_sink);
+
+	vector_int_free(&ints);
+	vector_double_free(&doubles);
+	vector_int_free(&int_out);
+	vector_double_free(&double_out);
+}
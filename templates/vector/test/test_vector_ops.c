@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <limits.h>
+
+#include "vector_ops_int.h"
+#include "vector_ops_double.h"
+
+/* The results of the bulk operations are compared with plain loops for every SIMD level and for
+ * sizes that exercise the scalar tails. The doubles are small integers so that sums are exact in
+ * any order of addition.
+ */
+
+void test_int(size_t size)
+{
+	struct vector_int vec;
+	vector_int_init(&vec);
+	for (size_t i = 0; i < size; i++) {
+		vector_int_append(&vec, rand() % 201 - 100);
+	}
+
+	int value = size > 0 ? vec.data[size - 1] : 7;
+	size_t find = size;
+	size_t count = 0;
+	int min = 0;
+	int max = 0;
+	int sum = 0;
+	for (size_t i = 0; i < size; i++) {
+		int x = vec.data[i];
+		if (x == value && find == size) find = i;
+		if (x == value) count++;
+		if (i == 0 || x < min) min = x;
+		if (i == 0 || x > max) max = x;
+		sum += x;
+	}
+
+	assert(vector_int_find(&vec, value) == find);
+	assert(vector_int_find(&vec, 1000) == size);
+	assert(vector_int_count(&vec, value) == count);
+
+	int result;
+	assert(vector_int_min(&vec, &result) == (size > 0));
+	if (size > 0) assert(result == min);
+	assert(vector_int_max(&vec, &result) == (size > 0));
+	if (size > 0) assert(result == max);
+	assert(vector_int_sum(&vec) == sum);
+
+	struct vector_int filtered;
+	vector_int_init(&filtered);
+	vector_int_append(&filtered, 12345);
+	assert(vector_int_filter(&filtered, &vec, -10, 20) == &filtered);
+	size_t j = 1;
+	for (size_t i = 0; i < size; i++) {
+		if (vec.data[i] >= -10 && vec.data[i] <= 20) {
+			assert(filtered.data[j] == vec.data[i]);
+			j++;
+		}
+	}
+	assert(filtered.size == j);
+	assert(filtered.data[0] == 12345);
+
+	struct vector_int mapped;
+	vector_int_init(&mapped);
+	for (size_t i = 0; i < size; i++) {
+		vector_int_append(&mapped, vec.data[i]);
+	}
+	vector_int_add_scalar(&mapped, 3);
+	vector_int_mul_scalar(&mapped, -2);
+	for (size_t i = 0; i < size; i++) {
+		assert(mapped.data[i] == (vec.data[i] + 3) * -2);
+	}
+
+	vector_int_free(&mapped);
+	vector_int_free(&filtered);
+	vector_int_free(&vec);
+}
+
+void test_double(size_t size)
+{
+	struct vector_double vec;
+	vector_double_init(&vec);
+	for (size_t i = 0; i < size; i++) {
+		vector_double_append(&vec, rand() % 2001 - 1000);
+	}
+
+	double value = size > 0 ? vec.data[size / 2] : 7;
+	size_t find = size;
+	size_t count = 0;
+	double min = 0;
+	double max = 0;
+	double sum = 0;
+	for (size_t i = 0; i < size; i++) {
+		double x = vec.data[i];
+		if (x == value && find == size) find = i;
+		if (x == value) count++;
+		if (i == 0 || x < min) min = x;
+		if (i == 0 || x > max) max = x;
+		sum += x;
+	}
+
+	assert(vector_double_find(&vec, value) == find);
+	assert(vector_double_find(&vec, 0.5) == size);
+	assert(vector_double_count(&vec, value) == count);
+
+	double result;
+	assert(vector_double_min(&vec, &result) == (size > 0));
+	if (size > 0) assert(result == min);
+	assert(vector_double_max(&vec, &result) == (size > 0));
+	if (size > 0) assert(result == max);
+	assert(vector_double_sum(&vec) == sum);
+
+	struct vector_double filtered;
+	vector_double_init(&filtered);
+	vector_double_filter(&filtered, &vec, -100.5, 250);
+	size_t j = 0;
+	for (size_t i = 0; i < size; i++) {
+		if (vec.data[i] >= -100.5 && vec.data[i] <= 250) {
+			assert(filtered.data[j] == vec.data[i]);
+			j++;
+		}
+	}
+	assert(filtered.size == j);
+
+	struct vector_double mapped;
+	vector_double_init(&mapped);
+	for (size_t i = 0; i < size; i++) {
+		vector_double_append(&mapped, vec.data[i]);
+	}
+	vector_double_mul_scalar(&mapped, 0.5);
+	vector_double_add_scalar(&mapped, 1);
+	for (size_t i = 0; i < size; i++) {
+		assert(mapped.data[i] == vec.data[i] * 0.5 + 1);
+	}
+
+	vector_double_free(&mapped);
+	vector_double_free(&filtered);
+	vector_double_free(&vec);
+}
+
+/* Integer sums, additions and multiplications wrap around instead of overflowing. */
+void test_wrap(void)
+{
+	struct vector_int vec;
+	vector_int_init(&vec);
+	for (int i = 0; i < 100; i++) {
+		vector_int_append(&vec, INT_MAX);
+	}
+
+	assert(vector_int_sum(&vec) == (int) (100u * INT_MAX));
+	vector_int_add_scalar(&vec, 2);
+	vector_int_mul_scalar(&vec, 3);
+	for (int i = 0; i < 100; i++) {
+		assert(vec.data[i] == (int) (((unsigned) INT_MAX + 2u) * 3u));
+	}
+
+	vector_int_free(&vec);
+}
+
+/* A selective filter of a large vector only grows dst with the result. */
+void test_filter_capacity(void)
+{
+	struct vector_int vec;
+	struct vector_int filtered;
+	vector_int_init(&vec);
+	vector_int_init(&filtered);
+	for (int i = 0; i < 100000; i++) {
+		vector_int_append(&vec, i);
+	}
+
+	assert(vector_int_filter(&filtered, &vec, 5000, 5099) == &filtered);
+	assert(filtered.size == 100);
+	assert(filtered.capacity < 10000);
+	for (int i = 0; i < 100; i++) {
+		assert(filtered.data[i] == 5000 + i);
+	}
+
+	vector_int_free(&vec);
+	vector_int_free(&filtered);
+}
+
+int main(void)
+{
+	const char *level_names[] = {"scalar", "sse2", "avx2"};
+
+	for (int level = vector_int_simd_scalar; level <= vector_int_simd_avx2; level++) {
+		enum vector_int_simd int_level = vector_int_set_simd_level(level);
+		enum vector_double_simd double_level = vector_double_set_simd_level(level);
+		assert((int) int_level == (int) double_level);
+		printf("testing simd level %s\n", level_names[int_level]);
+
+		srand(level);
+		for (size_t size = 0; size < 100; size++) {
+			test_int(size);
+			test_double(size);
+		}
+		test_int(100003);
+		test_double(100003);
+		test_wrap();
+	}
+	test_filter_capacity();
+
+	printf("tests ran succesfully\n");
+}
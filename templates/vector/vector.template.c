@@ -41,10 +41,19 @@ void vector_NAME_free(struct vector_NAME *vec)
 	free(vec->data);
 }
 
+/* realloc with size 0 may free the data and return NULL, so a capacity of 0 frees the data here. */
 struct vector_NAME *vector_NAME_set_capacity(struct vector_NAME *vec, size_t capacity)
 {
+	if (capacity == 0) {
+		free(vec->data);
+		vec->data = NULL;
+		vec->size = 0;
+		vec->capacity = 0;
+		return vec;
+	}
+
 	TYPE *data;
-	if ((data = realloc(vec->data, capacity * sizeof vec->data)) != NULL) {
+	if ((data = realloc(vec->data, capacity * sizeof *vec->data)) != NULL) {
 		vec->data = data;
 		vec->capacity = capacity;
 		if (vec->size > capacity) vec->size = capacity;
@@ -0,0 +1,53 @@
+/* This file is generated by the cgen program, https://github.com/morten-krogh/cgen. The cgen program is released under the MIT license.*/
+
+#include "vector_double.h"
+
+#include <stdlib.h>
+
+struct vector_double *vector_double_init(struct vector_double *vec)
+{
+	vec->data = NULL;
+	vec->size = 0;
+	vec->capacity = 0;
+
+	return vec;
+}
+
+void vector_double_free(struct vector_double *vec)
+{
+	free(vec->data);
+}
+
+/* realloc with size 0 may free the data and return NULL, so a capacity of 0 frees the data here. */
+struct vector_double *vector_double_set_capacity(struct vector_double *vec, size_t capacity)
+{
+	if (capacity == 0) {
+		free(vec->data);
+		vec->data = NULL;
+		vec->size = 0;
+		vec->capacity = 0;
+		return vec;
+	}
+
+	double *data;
+	if ((data = realloc(vec->data, capacity * sizeof *vec->data)) != NULL) {
+		vec->data = data;
+		vec->capacity = capacity;
+		if (vec->size > capacity) vec->size = capacity;
+	}
+
+	return vec;
+}
+
+struct vector_double *vector_double_append(struct vector_double *vec, double t)
+{
+	if (vec->size == vec->capacity) {
+		size_t new_capacity = 2 * vec->capacity + 1;
+		vector_double_set_capacity(vec, new_capacity);
+	}
+
+	vec->data[vec->size] = t;
+	vec->size++;
+	
+	return vec;
+}
@@ -0,0 +1,14 @@
+/* This file is generated by the cgen program, https://github.com/morten-krogh/cgen. The cgen program is released under the MIT license.*/
+
+#include <stddef.h>
+
+struct vector_double {
+       double *data;
+       size_t size;
+       size_t capacity;
+};
+
+struct vector_double *vector_double_init(struct vector_double *vec);
+void vector_double_free(struct vector_double *vec);
+struct vector_double *vector_double_set_capacity(struct vector_double *vec, size_t capacity);
+struct vector_double *vector_double_append(struct vector_double *vec, double t);
@@ -18,10 +18,19 @@ void vector_int_free(struct vector_int *vec)
 	free(vec->data);
 }
 
+/* realloc with size 0 may free the data and return NULL, so a capacity of 0 frees the data here. */
 struct vector_int *vector_int_set_capacity(struct vector_int *vec, size_t capacity)
 {
+	if (capacity == 0) {
+		free(vec->data);
+		vec->data = NULL;
+		vec->size = 0;
+		vec->capacity = 0;
+		return vec;
+	}
+
 	int *data;
-	if ((data = realloc(vec->data, capacity * sizeof vec->data)) != NULL) {
+	if ((data = realloc(vec->data, capacity * sizeof *vec->data)) != NULL) {
 		vec->data = data;
 		vec->capacity = capacity;
 		if (vec->size > capacity) vec->size = capacity;
@@ -0,0 +1,565 @@
+/*
+ * This template creates bulk operations for a vector of an arithmetic type. The vector itself is
+ * generated by vector.template.c and this template is enabled by a separate configuration file
+ * such as vector_ops_int.conf.
+ *
+ * The operations are find, count, min, max, sum, filter into another vector, and addition or
+ * multiplication of every element by a scalar. They are implemented three times: a scalar version,
+ * a version using 128 bit SSE2 registers and a version using 256 bit AVX2 registers. The best
+ * version supported by the cpu is selected at run time. The SIMD versions are written with the gcc
+ * vector extension which is also understood by clang. Other compilers and other cpu architectures
+ * get the scalar version. filter has an AVX2 version only for types of 4 and 8 bytes, which compacts
+ * the matching lanes with a permutation. Other types, and SSE2, filter with the scalar version.
+ *
+ * TYPE must be an arithmetic type of size 1, 2, 4 or 8 bytes, e.g. char, int, long, float or
+ * double. The order of additions in sum differs between the versions, so floating point sums can
+ * differ in the last bits. Results for floating point data containing NaN are unspecified.
+ *
+ * There are three template parameters: NAME, TYPE, and VECTOR_HEADER. VECTOR_HEADER is the header
+ * file generated by vector.template.c for the same NAME and TYPE.
+ *
+ * The typedef and struct below are just to make the template file syntactically correct c. It is a
+ * cgen comment and will be ignored.
+ */
+
+#include <stddef.h>
+
+typedef int TYPE;
+
+struct vector_NAME {
+	TYPE *data;
+	size_t size;
+	size_t capacity;
+};
+
+struct vector_NAME *vector_NAME_set_capacity(struct vector_NAME *vec, size_t capacity);
+
+// cgen header
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "VECTOR_HEADER"
+
+enum vector_NAME_simd {
+	vector_NAME_simd_scalar,
+	vector_NAME_simd_sse2,
+	vector_NAME_simd_avx2
+};
+
+enum vector_NAME_simd vector_NAME_simd_level(void);
+enum vector_NAME_simd vector_NAME_set_simd_level(enum vector_NAME_simd level);
+size_t vector_NAME_find(const struct vector_NAME *vec, TYPE t);
+size_t vector_NAME_count(const struct vector_NAME *vec, TYPE t);
+bool vector_NAME_min(const struct vector_NAME *vec, TYPE *min);
+bool vector_NAME_max(const struct vector_NAME *vec, TYPE *max);
+TYPE vector_NAME_sum(const struct vector_NAME *vec);
+struct vector_NAME *vector_NAME_filter(struct vector_NAME *dst, const struct vector_NAME *src, TYPE low, TYPE high);
+struct vector_NAME *vector_NAME_add_scalar(struct vector_NAME *vec, TYPE t);
+struct vector_NAME *vector_NAME_mul_scalar(struct vector_NAME *vec, TYPE t);
+// cgen source
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VECTOR_OPS_SIMD
+#include <immintrin.h>
+#endif
+
+/* Sums, additions and multiplications of integers are done in the unsigned type of the same size
+ * and converted back to TYPE. They wrap around modulo 2^bits instead of overflowing, which is
+ * undefined for signed types. Floating point types are used as they are. Other compilers than gcc
+ * and clang do the arithmetic in TYPE.
+ */
+#ifdef __GNUC__
+typedef __typeof__(__builtin_choose_expr(
+	__builtin_types_compatible_p(TYPE, float) || __builtin_types_compatible_p(TYPE, double), (TYPE) 0,
+	__builtin_choose_expr(sizeof(TYPE) == 1, (uint8_t) 0,
+	__builtin_choose_expr(sizeof(TYPE) == 2, (uint16_t) 0,
+	__builtin_choose_expr(sizeof(TYPE) == 4, (uint32_t) 0, (uint64_t) 0))))) wrap_NAME;
+#else
+typedef TYPE wrap_NAME;
+#endif
+
+/* The scalar versions are used on all platforms for the elements that do not fill a whole SIMD
+ * register and as the fallback when no SIMD version is available.
+ */
+
+static size_t vector_NAME_find_scalar(const TYPE *data, size_t size, TYPE t)
+{
+	for (size_t i = 0; i < size; i++) {
+		if (data[i] == t) return i;
+	}
+	return size;
+}
+
+static size_t vector_NAME_count_scalar(const TYPE *data, size_t size, TYPE t)
+{
+	size_t count = 0;
+	for (size_t i = 0; i < size; i++) {
+		count += data[i] == t;
+	}
+	return count;
+}
+
+static TYPE vector_NAME_min_scalar(const TYPE *data, size_t size, TYPE min)
+{
+	for (size_t i = 0; i < size; i++) {
+		if (data[i] < min) min = data[i];
+	}
+	return min;
+}
+
+static TYPE vector_NAME_max_scalar(const TYPE *data, size_t size, TYPE max)
+{
+	for (size_t i = 0; i < size; i++) {
+		if (data[i] > max) max = data[i];
+	}
+	return max;
+}
+
+static wrap_NAME vector_NAME_sum_scalar(const TYPE *data, size_t size)
+{
+	wrap_NAME sum = 0;
+	for (size_t i = 0; i < size; i++) {
+		sum += (wrap_NAME) data[i];
+	}
+	return sum;
+}
+
+#define VECTOR_OPS_FILTER_CHUNK 1024
+
+/* The elements in [low, high] are written to out which must have room for size elements. The
+ * number of written elements is returned. Every element is stored and the count is only advanced
+ * for matching elements, which avoids a hard to predict branch.
+ */
+static size_t vector_NAME_filter_scalar(const TYPE *data, size_t size, TYPE low, TYPE high, TYPE *out)
+{
+	size_t count = 0;
+	for (size_t i = 0; i < size; i++) {
+		out[count] = data[i];
+		count += data[i] >= low && data[i] <= high;
+	}
+	return count;
+}
+
+static void vector_NAME_add_scalar_scalar(TYPE *data, size_t size, TYPE t)
+{
+	for (size_t i = 0; i < size; i++) {
+		data[i] = (TYPE) (wrap_NAME) ((wrap_NAME) data[i] + (wrap_NAME) t);
+	}
+}
+
+/* The factor 1u keeps 16 bit operands from being promoted to int, where their product can overflow.
+ */
+static void vector_NAME_mul_scalar_scalar(TYPE *data, size_t size, TYPE t)
+{
+	for (size_t i = 0; i < size; i++) {
+		data[i] = (TYPE) (wrap_NAME) (1u * (wrap_NAME) data[i] * (wrap_NAME) t);
+	}
+}
+
+#ifdef VECTOR_OPS_SIMD
+
+/* The SIMD kernels are written once in the macro below and expanded for 16 byte SSE2 vectors and
+ * 32 byte AVX2 vectors. gcc lowers a vector comparison element by element when the vector is wider
+ * than the target registers, so each instruction set needs its own vector width. Loads and stores
+ * go through memcpy because vec->data is only aligned for TYPE. A comparison of two vectors gives
+ * a mask vector whose lanes are 0 or -1. The helpers are always inlined into the kernels, so the
+ * gcc warning about the AVX calling convention for vectors passed by value does not apply.
+ */
+
+#if !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+typedef TYPE vec_sse2_NAME __attribute__((vector_size(16)));
+typedef TYPE vec_avx2_NAME __attribute__((vector_size(32)));
+typedef uint64_t bits_sse2_NAME __attribute__((vector_size(16)));
+typedef uint64_t bits_avx2_NAME __attribute__((vector_size(32)));
+typedef __typeof__((vec_sse2_NAME){0} == (vec_sse2_NAME){0}) mask_sse2_NAME;
+typedef __typeof__((vec_avx2_NAME){0} == (vec_avx2_NAME){0}) mask_avx2_NAME;
+
+/* Sums, additions and multiplications are done on lanes of wrap_NAME like the scalar versions. */
+typedef wrap_NAME wrap_sse2_NAME __attribute__((vector_size(16)));
+typedef wrap_NAME wrap_avx2_NAME __attribute__((vector_size(32)));
+
+#define VECTOR_OPS_KERNELS(ISA)								\
+											\
+enum { lanes_##ISA##_NAME = sizeof(vec_##ISA##_NAME) / sizeof(TYPE) };			\
+											\
+static inline __attribute__((always_inline, target(#ISA)))				\
+vec_##ISA##_NAME vector_NAME_load_##ISA(const TYPE *data)				\
+{											\
+	vec_##ISA##_NAME v;								\
+	memcpy(&v, data, sizeof v);							\
+	return v;									\
+}											\
+											\
+static inline __attribute__((always_inline, target(#ISA)))				\
+vec_##ISA##_NAME vector_NAME_splat_##ISA(TYPE t)					\
+{											\
+	vec_##ISA##_NAME v;								\
+	for (size_t j = 0; j < lanes_##ISA##_NAME; j++) {				\
+		v[j] = t;								\
+	}										\
+	return v;									\
+}											\
+											\
+static inline __attribute__((always_inline, target(#ISA)))				\
+bool vector_NAME_any_##ISA(mask_##ISA##_NAME m)						\
+{											\
+	bits_##ISA##_NAME b = (bits_##ISA##_NAME) m;					\
+	uint64_t any = 0;								\
+	for (size_t j = 0; j < sizeof b / sizeof(uint64_t); j++) {			\
+		any |= b[j];								\
+	}										\
+	return any != 0;								\
+}											\
+											\
+/* The lanes of a where m is set and the lanes of b elsewhere */			\
+static inline __attribute__((always_inline, target(#ISA)))				\
+vec_##ISA##_NAME vector_NAME_blend_##ISA(vec_##ISA##_NAME a, vec_##ISA##_NAME b, mask_##ISA##_NAME m) \
+{											\
+	return (vec_##ISA##_NAME) (((mask_##ISA##_NAME) a & m) | ((mask_##ISA##_NAME) b & ~m)); \
+}											\
+											\
+static __attribute__((target(#ISA)))							\
+size_t vector_NAME_find_##ISA(const TYPE *data, size_t size, TYPE t)			\
+{											\
+	vec_##ISA##_NAME splat = vector_NAME_splat_##ISA(t);				\
+	size_t i = 0;									\
+	for (; i + lanes_##ISA##_NAME <= size; i += lanes_##ISA##_NAME) {		\
+		mask_##ISA##_NAME m = vector_NAME_load_##ISA(data + i) == splat;	\
+		if (vector_NAME_any_##ISA(m)) {						\
+			for (size_t j = 0;; j++) {					\
+				if (m[j]) return i + j;					\
+			}								\
+		}									\
+	}										\
+	return i + vector_NAME_find_scalar(data + i, size - i, t);			\
+}											\
+											\
+/* The matches are accumulated as -1 lanes in a mask vector. The lanes can be as narrow	\
+ * as 8 bits, so they are added up before they can overflow.				\
+ */											\
+static __attribute__((target(#ISA)))							\
+size_t vector_NAME_count_##ISA(const TYPE *data, size_t size, TYPE t)			\
+{											\
+	vec_##ISA##_NAME splat = vector_NAME_splat_##ISA(t);				\
+	size_t count = 0;								\
+	size_t i = 0;									\
+	while (i + lanes_##ISA##_NAME <= size) {					\
+		mask_##ISA##_NAME acc = (mask_##ISA##_NAME) (bits_##ISA##_NAME) {0};	\
+		for (int n = 0; n < 127 && i + lanes_##ISA##_NAME <= size; n++, i += lanes_##ISA##_NAME) { \
+			acc += vector_NAME_load_##ISA(data + i) == splat;		\
+		}									\
+		for (size_t j = 0; j < lanes_##ISA##_NAME; j++) {			\
+			count -= acc[j];						\
+		}									\
+	}										\
+	return count + vector_NAME_count_scalar(data + i, size - i, t);			\
+}											\
+											\
+/* size must be at least one vector */							\
+static __attribute__((target(#ISA)))							\
+TYPE vector_NAME_min_##ISA(const TYPE *data, size_t size)				\
+{											\
+	vec_##ISA##_NAME acc = vector_NAME_load_##ISA(data);				\
+	size_t i = lanes_##ISA##_NAME;							\
+	for (; i + lanes_##ISA##_NAME <= size; i += lanes_##ISA##_NAME) {		\
+		vec_##ISA##_NAME v = vector_NAME_load_##ISA(data + i);			\
+		acc = vector_NAME_blend_##ISA(v, acc, v < acc);				\
+	}										\
+	TYPE min = vector_NAME_min_scalar((const TYPE *) &acc, lanes_##ISA##_NAME, acc[0]); \
+	return vector_NAME_min_scalar(data + i, size - i, min);				\
+}											\
+											\
+/* size must be at least one vector */							\
+static __attribute__((target(#ISA)))							\
+TYPE vector_NAME_max_##ISA(const TYPE *data, size_t size)				\
+{											\
+	vec_##ISA##_NAME acc = vector_NAME_load_##ISA(data);				\
+	size_t i = lanes_##ISA##_NAME;							\
+	for (; i + lanes_##ISA##_NAME <= size; i += lanes_##ISA##_NAME) {		\
+		vec_##ISA##_NAME v = vector_NAME_load_##ISA(data + i);			\
+		acc = vector_NAME_blend_##ISA(v, acc, v > acc);				\
+	}										\
+	TYPE max = vector_NAME_max_scalar((const TYPE *) &acc, lanes_##ISA##_NAME, acc[0]); \
+	return vector_NAME_max_scalar(data + i, size - i, max);				\
+}											\
+											\
+static __attribute__((target(#ISA)))							\
+TYPE vector_NAME_sum_##ISA(const TYPE *data, size_t size)				\
+{											\
+	wrap_##ISA##_NAME acc = (wrap_##ISA##_NAME) vector_NAME_splat_##ISA(0);	\
+	size_t i = 0;									\
+	for (; i + lanes_##ISA##_NAME <= size; i += lanes_##ISA##_NAME) {		\
+		acc += (wrap_##ISA##_NAME) vector_NAME_load_##ISA(data + i);		\
+	}										\
+	wrap_NAME sum = 0;								\
+	for (size_t j = 0; j < lanes_##ISA##_NAME; j++) {				\
+		sum += acc[j];								\
+	}										\
+	return (TYPE) (wrap_NAME) (sum + vector_NAME_sum_scalar(data + i, size - i));	\
+}											\
+											\
+static __attribute__((target(#ISA)))							\
+void vector_NAME_add_scalar_##ISA(TYPE *data, size_t size, TYPE t)			\
+{											\
+	wrap_##ISA##_NAME splat = (wrap_##ISA##_NAME) vector_NAME_splat_##ISA(t);	\
+	size_t i = 0;									\
+	for (; i + lanes_##ISA##_NAME <= size; i += lanes_##ISA##_NAME) {		\
+		wrap_##ISA##_NAME v = (wrap_##ISA##_NAME) vector_NAME_load_##ISA(data + i) + splat; \
+		memcpy(data + i, &v, sizeof v);						\
+	}										\
+	vector_NAME_add_scalar_scalar(data + i, size - i, t);				\
+}											\
+											\
+static __attribute__((target(#ISA)))							\
+void vector_NAME_mul_scalar_##ISA(TYPE *data, size_t size, TYPE t)			\
+{											\
+	wrap_##ISA##_NAME splat = (wrap_##ISA##_NAME) vector_NAME_splat_##ISA(t);	\
+	size_t i = 0;									\
+	for (; i + lanes_##ISA##_NAME <= size; i += lanes_##ISA##_NAME) {		\
+		wrap_##ISA##_NAME v = (wrap_##ISA##_NAME) vector_NAME_load_##ISA(data + i) * splat; \
+		memcpy(data + i, &v, sizeof v);						\
+	}										\
+	vector_NAME_mul_scalar_scalar(data + i, size - i, t);				\
+}
+
+VECTOR_OPS_KERNELS(sse2)
+VECTOR_OPS_KERNELS(avx2)
+
+/* filter on AVX2 for types of 4 and 8 bytes. The lanes of a vector that match are moved to the
+ * front by a permutation of its eight 32 bit units, the whole vector is stored and the count is
+ * advanced by the number of matches. The permutation is looked up by the bit mask of the matching
+ * units. An 8 byte lane covers two units with the same mask bit, which stay together. The table
+ * entry for mask m holds the indices of the set bits of m, one per byte, and is computed by the
+ * macros below.
+ */
+#define VECTOR_OPS_BITS(m) (((m) & 1) + ((m) >> 1 & 1) + ((m) >> 2 & 1) + ((m) >> 3 & 1) + \
+	((m) >> 4 & 1) + ((m) >> 5 & 1) + ((m) >> 6 & 1) + ((m) >> 7 & 1))
+#define VECTOR_OPS_INDEX(m, j) (((uint64_t) ((m) >> (j) & 1) * (j)) << (8 * VECTOR_OPS_BITS((m) & ((1 << (j)) - 1))))
+#define VECTOR_OPS_COMPRESS(m) (VECTOR_OPS_INDEX(m, 0) | VECTOR_OPS_INDEX(m, 1) | VECTOR_OPS_INDEX(m, 2) | \
+	VECTOR_OPS_INDEX(m, 3) | VECTOR_OPS_INDEX(m, 4) | VECTOR_OPS_INDEX(m, 5) | VECTOR_OPS_INDEX(m, 6) | \
+	VECTOR_OPS_INDEX(m, 7))
+#define VECTOR_OPS_COMPRESS4(m) VECTOR_OPS_COMPRESS(m), VECTOR_OPS_COMPRESS((m) + 1), \
+	VECTOR_OPS_COMPRESS((m) + 2), VECTOR_OPS_COMPRESS((m) + 3)
+#define VECTOR_OPS_COMPRESS16(m) VECTOR_OPS_COMPRESS4(m), VECTOR_OPS_COMPRESS4((m) + 4), \
+	VECTOR_OPS_COMPRESS4((m) + 8), VECTOR_OPS_COMPRESS4((m) + 12)
+#define VECTOR_OPS_COMPRESS64(m) VECTOR_OPS_COMPRESS16(m), VECTOR_OPS_COMPRESS16((m) + 16), \
+	VECTOR_OPS_COMPRESS16((m) + 32), VECTOR_OPS_COMPRESS16((m) + 48)
+
+static const uint64_t vector_NAME_compress[256] = {
+	VECTOR_OPS_COMPRESS64(0), VECTOR_OPS_COMPRESS64(64), VECTOR_OPS_COMPRESS64(128), VECTOR_OPS_COMPRESS64(192)
+};
+
+/* Like vector_NAME_filter_scalar. The whole vector is stored, and the count only ever trails i, so
+ * out has room for it.
+ */
+static __attribute__((target("avx2")))
+size_t vector_NAME_filter_avx2(const TYPE *data, size_t size, TYPE low, TYPE high, TYPE *out)
+{
+	vec_avx2_NAME l = vector_NAME_splat_avx2(low);
+	vec_avx2_NAME h = vector_NAME_splat_avx2(high);
+	size_t count = 0;
+	size_t i = 0;
+	for (; i + lanes_avx2_NAME <= size; i += lanes_avx2_NAME) {
+		vec_avx2_NAME v = vector_NAME_load_avx2(data + i);
+		mask_avx2_NAME m = (v >= l) & (v <= h);
+		int bits = _mm256_movemask_ps((__m256) m);
+		__m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (vector_NAME_compress + bits)));
+		_mm256_storeu_si256((__m256i *) (out + count), _mm256_permutevar8x32_epi32((__m256i) v, index));
+		count += (size_t) __builtin_popcount(bits) * 4 / sizeof(TYPE);
+	}
+	return count + vector_NAME_filter_scalar(data + i, size - i, low, high, out + count);
+}
+
+#endif
+
+/* The level used by the operations. It is only written by vector_NAME_set_simd_level. */
+static enum vector_NAME_simd vector_NAME_level = vector_NAME_simd_scalar;
+
+/* The level is used for all subsequent operations. The return value is the level actually used
+ * which is lower than the argument if the compiler or cpu does not support the argument. The level
+ * is not synchronized with operations running in other threads. Before main is entered it is set to
+ * the best supported level.
+ */
+enum vector_NAME_simd vector_NAME_set_simd_level(enum vector_NAME_simd level)
+{
+	enum vector_NAME_simd supported = vector_NAME_simd_scalar;
+#ifdef VECTOR_OPS_SIMD
+	if (__builtin_cpu_supports("avx2")) supported = vector_NAME_simd_avx2;
+	else if (__builtin_cpu_supports("sse2")) supported = vector_NAME_simd_sse2;
+#endif
+	vector_NAME_level = level < supported ? level : supported;
+	return vector_NAME_level;
+}
+
+enum vector_NAME_simd vector_NAME_simd_level(void)
+{
+	return vector_NAME_level;
+}
+
+#ifdef VECTOR_OPS_SIMD
+/* Constructors can run before the cpu model used by __builtin_cpu_supports is initialized, so it is
+ * initialized here first.
+ */
+static __attribute__((constructor)) void vector_NAME_init_simd_level(void)
+{
+	__builtin_cpu_init();
+	vector_NAME_set_simd_level(vector_NAME_simd_avx2);
+}
+#endif
+
+/* The index of the first element equal to t is returned. vec->size is returned if there is none.
+ */
+size_t vector_NAME_find(const struct vector_NAME *vec, TYPE t)
+{
+	switch (vector_NAME_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_NAME_simd_avx2: return vector_NAME_find_avx2(vec->data, vec->size, t);
+	case vector_NAME_simd_sse2: return vector_NAME_find_sse2(vec->data, vec->size, t);
+#endif
+	default: return vector_NAME_find_scalar(vec->data, vec->size, t);
+	}
+}
+
+size_t vector_NAME_count(const struct vector_NAME *vec, TYPE t)
+{
+	switch (vector_NAME_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_NAME_simd_avx2: return vector_NAME_count_avx2(vec->data, vec->size, t);
+	case vector_NAME_simd_sse2: return vector_NAME_count_sse2(vec->data, vec->size, t);
+#endif
+	default: return vector_NAME_count_scalar(vec->data, vec->size, t);
+	}
+}
+
+/* The smallest element is written to min. The bool return value is false if the vector is empty
+ * in which case min is untouched.
+ */
+bool vector_NAME_min(const struct vector_NAME *vec, TYPE *min)
+{
+	if (vec->size == 0) return false;
+	switch (vector_NAME_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_NAME_simd_avx2:
+		if (vec->size < lanes_avx2_NAME) break;
+		*min = vector_NAME_min_avx2(vec->data, vec->size);
+		return true;
+	case vector_NAME_simd_sse2:
+		if (vec->size < lanes_sse2_NAME) break;
+		*min = vector_NAME_min_sse2(vec->data, vec->size);
+		return true;
+#endif
+	default:
+		break;
+	}
+	*min = vector_NAME_min_scalar(vec->data, vec->size, vec->data[0]);
+	return true;
+}
+
+/* The largest element is written to max. The bool return value is false if the vector is empty
+ * in which case max is untouched.
+ */
+bool vector_NAME_max(const struct vector_NAME *vec, TYPE *max)
+{
+	if (vec->size == 0) return false;
+	switch (vector_NAME_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_NAME_simd_avx2:
+		if (vec->size < lanes_avx2_NAME) break;
+		*max = vector_NAME_max_avx2(vec->data, vec->size);
+		return true;
+	case vector_NAME_simd_sse2:
+		if (vec->size < lanes_sse2_NAME) break;
+		*max = vector_NAME_max_sse2(vec->data, vec->size);
+		return true;
+#endif
+	default:
+		break;
+	}
+	*max = vector_NAME_max_scalar(vec->data, vec->size, vec->data[0]);
+	return true;
+}
+
+/* The sum is accumulated in TYPE. Integer sums wrap around modulo 2^bits of TYPE on overflow.
+ * add_scalar and mul_scalar wrap around in the same way.
+ */
+TYPE vector_NAME_sum(const struct vector_NAME *vec)
+{
+	switch (vector_NAME_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_NAME_simd_avx2: return vector_NAME_sum_avx2(vec->data, vec->size);
+	case vector_NAME_simd_sse2: return vector_NAME_sum_sse2(vec->data, vec->size);
+#endif
+	default: return (TYPE) vector_NAME_sum_scalar(vec->data, vec->size);
+	}
+}
+
+/* There is no permutation of 1 and 2 byte lanes in AVX2 and none at all in SSE2, so those filter
+ * with the scalar version.
+ */
+static size_t vector_NAME_filter_chunk(const TYPE *data, size_t size, TYPE low, TYPE high, TYPE *out)
+{
+#ifdef VECTOR_OPS_SIMD
+	if (vector_NAME_simd_level() == vector_NAME_simd_avx2 && sizeof(TYPE) >= 4) {
+		return vector_NAME_filter_avx2(data, size, low, high, out);
+	}
+#endif
+	return vector_NAME_filter_scalar(data, size, low, high, out);
+}
+
+/* The elements of src in the closed interval [low, high] are appended to dst in their original
+ * order. dst and src must be different vectors. src is filtered in chunks of
+ * VECTOR_OPS_FILTER_CHUNK elements and dst only needs room for one chunk beyond the elements
+ * written so far, so dst grows with the result and not with src. dst is returned. NULL is returned
+ * if memory could not be allocated, in which case dst holds the matching elements of a prefix of
+ * src.
+ */
+struct vector_NAME *vector_NAME_filter(struct vector_NAME *dst, const struct vector_NAME *src, TYPE low, TYPE high)
+{
+	for (size_t i = 0; i < src->size; i += VECTOR_OPS_FILTER_CHUNK) {
+		size_t n = src->size - i < VECTOR_OPS_FILTER_CHUNK ? src->size - i : VECTOR_OPS_FILTER_CHUNK;
+		if (dst->capacity - dst->size < n) {
+			size_t capacity = 2 * dst->capacity;
+			if (capacity < dst->size + n) capacity = dst->size + n;
+			vector_NAME_set_capacity(dst, capacity);
+			if (dst->capacity - dst->size < n) return NULL;
+		}
+		dst->size += vector_NAME_filter_chunk(src->data + i, n, low, high, dst->data + dst->size);
+	}
+
+	return dst;
+}
+
+/* t is added to every element of vec. vec is returned. */
+struct vector_NAME *vector_NAME_add_scalar(struct vector_NAME *vec, TYPE t)
+{
+	switch (vector_NAME_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_NAME_simd_avx2: vector_NAME_add_scalar_avx2(vec->data, vec->size, t); break;
+	case vector_NAME_simd_sse2: vector_NAME_add_scalar_sse2(vec->data, vec->size, t); break;
+#endif
+	default: vector_NAME_add_scalar_scalar(vec->data, vec->size, t); break;
+	}
+
+	return vec;
+}
+
+/* Every element of vec is multiplied by t. vec is returned. */
+struct vector_NAME *vector_NAME_mul_scalar(struct vector_NAME *vec, TYPE t)
+{
+	switch (vector_NAME_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_NAME_simd_avx2: vector_NAME_mul_scalar_avx2(vec->data, vec->size, t); break;
+	case vector_NAME_simd_sse2: vector_NAME_mul_scalar_sse2(vec->data, vec->size, t); break;
+#endif
+	default: vector_NAME_mul_scalar_scalar(vec->data, vec->size, t); break;
+	}
+
+	return vec;
+}
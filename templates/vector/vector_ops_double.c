@@ -0,0 +1,508 @@
+/* This file is generated by the cgen program, https://github.com/morten-krogh/cgen. The cgen program is released under the MIT license.*/
+
+#include "vector_ops_double.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VECTOR_OPS_SIMD
+#include <immintrin.h>
+#endif
+
+/* Sums, additions and multiplications of integers are done in the unsigned type of the same size
+ * and converted back to double. They wrap around modulo 2^bits instead of overflowing, which is
+ * undefined for signed types. Floating point types are used as they are. Other compilers than gcc
+ * and clang do the arithmetic in double.
+ */
+#ifdef __GNUC__
+typedef __typeof__(__builtin_choose_expr(
+	__builtin_types_compatible_p(double, float) || __builtin_types_compatible_p(double, double), (double) 0,
+	__builtin_choose_expr(sizeof(double) == 1, (uint8_t) 0,
+	__builtin_choose_expr(sizeof(double) == 2, (uint16_t) 0,
+	__builtin_choose_expr(sizeof(double) == 4, (uint32_t) 0, (uint64_t) 0))))) wrap_double;
+#else
+typedef double wrap_double;
+#endif
+
+/* The scalar versions are used on all platforms for the elements that do not fill a whole SIMD
+ * register and as the fallback when no SIMD version is available.
+ */
+
+static size_t vector_double_find_scalar(const double *data, size_t size, double t)
+{
+	for (size_t i = 0; i < size; i++) {
+		if (data[i] == t) return i;
+	}
+	return size;
+}
+
+static size_t vector_double_count_scalar(const double *data, size_t size, double t)
+{
+	size_t count = 0;
+	for (size_t i = 0; i < size; i++) {
+		count += data[i] == t;
+	}
+	return count;
+}
+
+static double vector_double_min_scalar(const double *data, size_t size, double min)
+{
+	for (size_t i = 0; i < size; i++) {
+		if (data[i] < min) min = data[i];
+	}
+	return min;
+}
+
+static double vector_double_max_scalar(const double *data, size_t size, double max)
+{
+	for (size_t i = 0; i < size; i++) {
+		if (data[i] > max) max = data[i];
+	}
+	return max;
+}
+
+static wrap_double vector_double_sum_scalar(const double *data, size_t size)
+{
+	wrap_double sum = 0;
+	for (size_t i = 0; i < size; i++) {
+		sum += (wrap_double) data[i];
+	}
+	return sum;
+}
+
+#define VECTOR_OPS_FILTER_CHUNK 1024
+
+/* The elements in [low, high] are written to out which must have room for size elements. The
+ * number of written elements is returned. Every element is stored and the count is only advanced
+ * for matching elements, which avoids a hard to predict branch.
+ */
+static size_t vector_double_filter_scalar(const double *data, size_t size, double low, double high, double *out)
+{
+	size_t count = 0;
+	for (size_t i = 0; i < size; i++) {
+		out[count] = data[i];
+		count += data[i] >= low && data[i] <= high;
+	}
+	return count;
+}
+
+static void vector_double_add_scalar_scalar(double *data, size_t size, double t)
+{
+	for (size_t i = 0; i < size; i++) {
+		data[i] = (double) (wrap_double) ((wrap_double) data[i] + (wrap_double) t);
+	}
+}
+
+/* The factor 1u keeps 16 bit operands from being promoted to int, where their product can overflow.
+ */
+static void vector_double_mul_scalar_scalar(double *data, size_t size, double t)
+{
+	for (size_t i = 0; i < size; i++) {
+		data[i] = (double) (wrap_double) (1u * (wrap_double) data[i] * (wrap_double) t);
+	}
+}
+
+#ifdef VECTOR_OPS_SIMD
+
+/* The SIMD kernels are written once in the macro below and expanded for 16 byte SSE2 vectors and
+ * 32 byte AVX2 vectors. gcc lowers a vector comparison element by element when the vector is wider
+ * than the target registers, so each instruction set needs its own vector width. Loads and stores
+ * go through memcpy because vec->data is only aligned for double. A comparison of two vectors gives
+ * a mask vector whose lanes are 0 or -1. The helpers are always inlined into the kernels, so the
+ * gcc warning about the AVX calling convention for vectors passed by value does not apply.
+ */
+
+#if !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+typedef double vec_sse2_double __attribute__((vector_size(16)));
+typedef double vec_avx2_double __attribute__((vector_size(32)));
+typedef uint64_t bits_sse2_double __attribute__((vector_size(16)));
+typedef uint64_t bits_avx2_double __attribute__((vector_size(32)));
+typedef __typeof__((vec_sse2_double){0} == (vec_sse2_double){0}) mask_sse2_double;
+typedef __typeof__((vec_avx2_double){0} == (vec_avx2_double){0}) mask_avx2_double;
+
+/* Sums, additions and multiplications are done on lanes of wrap_double like the scalar versions. */
+typedef wrap_double wrap_sse2_double __attribute__((vector_size(16)));
+typedef wrap_double wrap_avx2_double __attribute__((vector_size(32)));
+
+#define VECTOR_OPS_KERNELS(ISA)								\
+											\
+enum { lanes_##ISA##_double = sizeof(vec_##ISA##_double) / sizeof(double) };			\
+											\
+static inline __attribute__((always_inline, target(#ISA)))				\
+vec_##ISA##_double vector_double_load_##ISA(const double *data)				\
+{											\
+	vec_##ISA##_double v;								\
+	memcpy(&v, data, sizeof v);							\
+	return v;									\
+}											\
+											\
+static inline __attribute__((always_inline, target(#ISA)))				\
+vec_##ISA##_double vector_double_splat_##ISA(double t)					\
+{											\
+	vec_##ISA##_double v;								\
+	for (size_t j = 0; j < lanes_##ISA##_double; j++) {				\
+		v[j] = t;								\
+	}										\
+	return v;									\
+}											\
+											\
+static inline __attribute__((always_inline, target(#ISA)))				\
+bool vector_double_any_##ISA(mask_##ISA##_double m)						\
+{											\
+	bits_##ISA##_double b = (bits_##ISA##_double) m;					\
+	uint64_t any = 0;								\
+	for (size_t j = 0; j < sizeof b / sizeof(uint64_t); j++) {			\
+		any |= b[j];								\
+	}										\
+	return any != 0;								\
+}											\
+											\
+/* The lanes of a where m is set and the lanes of b elsewhere */			\
+static inline __attribute__((always_inline, target(#ISA)))				\
+vec_##ISA##_double vector_double_blend_##ISA(vec_##ISA##_double a, vec_##ISA##_double b, mask_##ISA##_double m) \
+{											\
+	return (vec_##ISA##_double) (((mask_##ISA##_double) a & m) | ((mask_##ISA##_double) b & ~m)); \
+}											\
+											\
+static __attribute__((target(#ISA)))							\
+size_t vector_double_find_##ISA(const double *data, size_t size, double t)			\
+{											\
+	vec_##ISA##_double splat = vector_double_splat_##ISA(t);				\
+	size_t i = 0;									\
+	for (; i + lanes_##ISA##_double <= size; i += lanes_##ISA##_double) {		\
+		mask_##ISA##_double m = vector_double_load_##ISA(data + i) == splat;	\
+		if (vector_double_any_##ISA(m)) {						\
+			for (size_t j = 0;; j++) {					\
+				if (m[j]) return i + j;					\
+			}								\
+		}									\
+	}										\
+	return i + vector_double_find_scalar(data + i, size - i, t);			\
+}											\
+											\
+/* The matches are accumulated as -1 lanes in a mask vector. The lanes can be as narrow	\
+ * as 8 bits, so they are added up before they can overflow.				\
+ */											\
+static __attribute__((target(#ISA)))							\
+size_t vector_double_count_##ISA(const double *data, size_t size, double t)			\
+{											\
+	vec_##ISA##_double splat = vector_double_splat_##ISA(t);				\
+	size_t count = 0;								\
+	size_t i = 0;									\
+	while (i + lanes_##ISA##_double <= size) {					\
+		mask_##ISA##_double acc = (mask_##ISA##_double) (bits_##ISA##_double) {0};	\
+		for (int n = 0; n < 127 && i + lanes_##ISA##_double <= size; n++, i += lanes_##ISA##_double) { \
+			acc += vector_double_load_##ISA(data + i) == splat;		\
+		}									\
+		for (size_t j = 0; j < lanes_##ISA##_double; j++) {			\
+			count -= acc[j];						\
+		}									\
+	}										\
+	return count + vector_double_count_scalar(data + i, size - i, t);			\
+}											\
+											\
+/* size must be at least one vector */							\
+static __attribute__((target(#ISA)))							\
+double vector_double_min_##ISA(const double *data, size_t size)				\
+{											\
+	vec_##ISA##_double acc = vector_double_load_##ISA(data);				\
+	size_t i = lanes_##ISA##_double;							\
+	for (; i + lanes_##ISA##_double <= size; i += lanes_##ISA##_double) {		\
+		vec_##ISA##_double v = vector_double_load_##ISA(data + i);			\
+		acc = vector_double_blend_##ISA(v, acc, v < acc);				\
+	}										\
+	double min = vector_double_min_scalar((const double *) &acc, lanes_##ISA##_double, acc[0]); \
+	return vector_double_min_scalar(data + i, size - i, min);				\
+}											\
+											\
+/* size must be at least one vector */							\
+static __attribute__((target(#ISA)))							\
+double vector_double_max_##ISA(const double *data, size_t size)				\
+{											\
+	vec_##ISA##_double acc = vector_double_load_##ISA(data);				\
+	size_t i = lanes_##ISA##_double;							\
+	for (; i + lanes_##ISA##_double <= size; i += lanes_##ISA##_double) {		\
+		vec_##ISA##_double v = vector_double_load_##ISA(data + i);			\
+		acc = vector_double_blend_##ISA(v, acc, v > acc);				\
+	}										\
+	double max = vector_double_max_scalar((const double *) &acc, lanes_##ISA##_double, acc[0]); \
+	return vector_double_max_scalar(data + i, size - i, max);				\
+}											\
+											\
+static __attribute__((target(#ISA)))							\
+double vector_double_sum_##ISA(const double *data, size_t size)				\
+{											\
+	wrap_##ISA##_double acc = (wrap_##ISA##_double) vector_double_splat_##ISA(0);	\
+	size_t i = 0;									\
+	for (; i + lanes_##ISA##_double <= size; i += lanes_##ISA##_double) {		\
+		acc += (wrap_##ISA##_double) vector_double_load_##ISA(data + i);		\
+	}										\
+	wrap_double sum = 0;								\
+	for (size_t j = 0; j < lanes_##ISA##_double; j++) {				\
+		sum += acc[j];								\
+	}										\
+	return (double) (wrap_double) (sum + vector_double_sum_scalar(data + i, size - i));	\
+}											\
+											\
+static __attribute__((target(#ISA)))							\
+void vector_double_add_scalar_##ISA(double *data, size_t size, double t)			\
+{											\
+	wrap_##ISA##_double splat = (wrap_##ISA##_double) vector_double_splat_##ISA(t);	\
+	size_t i = 0;									\
+	for (; i + lanes_##ISA##_double <= size; i += lanes_##ISA##_double) {		\
+		wrap_##ISA##_double v = (wrap_##ISA##_double) vector_double_load_##ISA(data + i) + splat; \
+		memcpy(data + i, &v, sizeof v);						\
+	}										\
+	vector_double_add_scalar_scalar(data + i, size - i, t);				\
+}											\
+											\
+static __attribute__((target(#ISA)))							\
+void vector_double_mul_scalar_##ISA(double *data, size_t size, double t)			\
+{											\
+	wrap_##ISA##_double splat = (wrap_##ISA##_double) vector_double_splat_##ISA(t);	\
+	size_t i = 0;									\
+	for (; i + lanes_##ISA##_double <= size; i += lanes_##ISA##_double) {		\
+		wrap_##ISA##_double v = (wrap_##ISA##_double) vector_double_load_##ISA(data + i) * splat; \
+		memcpy(data + i, &v, sizeof v);						\
+	}										\
+	vector_double_mul_scalar_scalar(data + i, size - i, t);				\
+}
+
+VECTOR_OPS_KERNELS(sse2)
+VECTOR_OPS_KERNELS(avx2)
+
+/* filter on AVX2 for types of 4 and 8 bytes. The lanes of a vector that match are moved to the
+ * front by a permutation of its eight 32 bit units, the whole vector is stored and the count is
+ * advanced by the number of matches. The permutation is looked up by the bit mask of the matching
+ * units. An 8 byte lane covers two units with the same mask bit, which stay together. The table
+ * entry for mask m holds the indices of the set bits of m, one per byte, and is computed by the
+ * macros below.
+ */
+#define VECTOR_OPS_BITS(m) (((m) & 1) + ((m) >> 1 & 1) + ((m) >> 2 & 1) + ((m) >> 3 & 1) + \
+	((m) >> 4 & 1) + ((m) >> 5 & 1) + ((m) >> 6 & 1) + ((m) >> 7 & 1))
+#define VECTOR_OPS_INDEX(m, j) (((uint64_t) ((m) >> (j) & 1) * (j)) << (8 * VECTOR_OPS_BITS((m) & ((1 << (j)) - 1))))
+#define VECTOR_OPS_COMPRESS(m) (VECTOR_OPS_INDEX(m, 0) | VECTOR_OPS_INDEX(m, 1) | VECTOR_OPS_INDEX(m, 2) | \
+	VECTOR_OPS_INDEX(m, 3) | VECTOR_OPS_INDEX(m, 4) | VECTOR_OPS_INDEX(m, 5) | VECTOR_OPS_INDEX(m, 6) | \
+	VECTOR_OPS_INDEX(m, 7))
+#define VECTOR_OPS_COMPRESS4(m) VECTOR_OPS_COMPRESS(m), VECTOR_OPS_COMPRESS((m) + 1), \
+	VECTOR_OPS_COMPRESS((m) + 2), VECTOR_OPS_COMPRESS((m) + 3)
+#define VECTOR_OPS_COMPRESS16(m) VECTOR_OPS_COMPRESS4(m), VECTOR_OPS_COMPRESS4((m) + 4), \
+	VECTOR_OPS_COMPRESS4((m) + 8), VECTOR_OPS_COMPRESS4((m) + 12)
+#define VECTOR_OPS_COMPRESS64(m) VECTOR_OPS_COMPRESS16(m), VECTOR_OPS_COMPRESS16((m) + 16), \
+	VECTOR_OPS_COMPRESS16((m) + 32), VECTOR_OPS_COMPRESS16((m) + 48)
+
+static const uint64_t vector_double_compress[256] = {
+	VECTOR_OPS_COMPRESS64(0), VECTOR_OPS_COMPRESS64(64), VECTOR_OPS_COMPRESS64(128), VECTOR_OPS_COMPRESS64(192)
+};
+
+/* Like vector_double_filter_scalar. The whole vector is stored, and the count only ever trails i, so
+ * out has room for it.
+ */
+static __attribute__((target("avx2")))
+size_t vector_double_filter_avx2(const double *data, size_t size, double low, double high, double *out)
+{
+	vec_avx2_double l = vector_double_splat_avx2(low);
+	vec_avx2_double h = vector_double_splat_avx2(high);
+	size_t count = 0;
+	size_t i = 0;
+	for (; i + lanes_avx2_double <= size; i += lanes_avx2_double) {
+		vec_avx2_double v = vector_double_load_avx2(data + i);
+		mask_avx2_double m = (v >= l) & (v <= h);
+		int bits = _mm256_movemask_ps((__m256) m);
+		__m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (vector_double_compress + bits)));
+		_mm256_storeu_si256((__m256i *) (out + count), _mm256_permutevar8x32_epi32((__m256i) v, index));
+		count += (size_t) __builtin_popcount(bits) * 4 / sizeof(double);
+	}
+	return count + vector_double_filter_scalar(data + i, size - i, low, high, out + count);
+}
+
+#endif
+
+/* The level used by the operations. It is only written by vector_double_set_simd_level. */
+static enum vector_double_simd vector_double_level = vector_double_simd_scalar;
+
+/* The level is used for all subsequent operations. The return value is the level actually used
+ * which is lower than the argument if the compiler or cpu does not support the argument. The level
+ * is not synchronized with operations running in other threads. Before main is entered it is set to
+ * the best supported level.
+ */
+enum vector_double_simd vector_double_set_simd_level(enum vector_double_simd level)
+{
+	enum vector_double_simd supported = vector_double_simd_scalar;
+#ifdef VECTOR_OPS_SIMD
+	if (__builtin_cpu_supports("avx2")) supported = vector_double_simd_avx2;
+	else if (__builtin_cpu_supports("sse2")) supported = vector_double_simd_sse2;
+#endif
+	vector_double_level = level < supported ? level : supported;
+	return vector_double_level;
+}
+
+enum vector_double_simd vector_double_simd_level(void)
+{
+	return vector_double_level;
+}
+
+#ifdef VECTOR_OPS_SIMD
+/* Constructors can run before the cpu model used by __builtin_cpu_supports is initialized, so it is
+ * initialized here first.
+ */
+static __attribute__((constructor)) void vector_double_init_simd_level(void)
+{
+	__builtin_cpu_init();
+	vector_double_set_simd_level(vector_double_simd_avx2);
+}
+#endif
+
+/* The index of the first element equal to t is returned. vec->size is returned if there is none.
+ */
+size_t vector_double_find(const struct vector_double *vec, double t)
+{
+	switch (vector_double_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_double_simd_avx2: return vector_double_find_avx2(vec->data, vec->size, t);
+	case vector_double_simd_sse2: return vector_double_find_sse2(vec->data, vec->size, t);
+#endif
+	default: return vector_double_find_scalar(vec->data, vec->size, t);
+	}
+}
+
+size_t vector_double_count(const struct vector_double *vec, double t)
+{
+	switch (vector_double_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_double_simd_avx2: return vector_double_count_avx2(vec->data, vec->size, t);
+	case vector_double_simd_sse2: return vector_double_count_sse2(vec->data, vec->size, t);
+#endif
+	default: return vector_double_count_scalar(vec->data, vec->size, t);
+	}
+}
+
+/* The smallest element is written to min. The bool return value is false if the vector is empty
+ * in which case min is untouched.
+ */
+bool vector_double_min(const struct vector_double *vec, double *min)
+{
+	if (vec->size == 0) return false;
+	switch (vector_double_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_double_simd_avx2:
+		if (vec->size < lanes_avx2_double) break;
+		*min = vector_double_min_avx2(vec->data, vec->size);
+		return true;
+	case vector_double_simd_sse2:
+		if (vec->size < lanes_sse2_double) break;
+		*min = vector_double_min_sse2(vec->data, vec->size);
+		return true;
+#endif
+	default:
+		break;
+	}
+	*min = vector_double_min_scalar(vec->data, vec->size, vec->data[0]);
+	return true;
+}
+
+/* The largest element is written to max. The bool return value is false if the vector is empty
+ * in which case max is untouched.
+ */
+bool vector_double_max(const struct vector_double *vec, double *max)
+{
+	if (vec->size == 0) return false;
+	switch (vector_double_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_double_simd_avx2:
+		if (vec->size < lanes_avx2_double) break;
+		*max = vector_double_max_avx2(vec->data, vec->size);
+		return true;
+	case vector_double_simd_sse2:
+		if (vec->size < lanes_sse2_double) break;
+		*max = vector_double_max_sse2(vec->data, vec->size);
+		return true;
+#endif
+	default:
+		break;
+	}
+	*max = vector_double_max_scalar(vec->data, vec->size, vec->data[0]);
+	return true;
+}
+
+/* The sum is accumulated in double. Integer sums wrap around modulo 2^bits of double on overflow.
+ * add_scalar and mul_scalar wrap around in the same way.
+ */
+double vector_double_sum(const struct vector_double *vec)
+{
+	switch (vector_double_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_double_simd_avx2: return vector_double_sum_avx2(vec->data, vec->size);
+	case vector_double_simd_sse2: return vector_double_sum_sse2(vec->data, vec->size);
+#endif
+	default: return (double) vector_double_sum_scalar(vec->data, vec->size);
+	}
+}
+
+/* There is no permutation of 1 and 2 byte lanes in AVX2 and none at all in SSE2, so those filter
+ * with the scalar version.
+ */
+static size_t vector_double_filter_chunk(const double *data, size_t size, double low, double high, double *out)
+{
+#ifdef VECTOR_OPS_SIMD
+	if (vector_double_simd_level() == vector_double_simd_avx2 && sizeof(double) >= 4) {
+		return vector_double_filter_avx2(data, size, low, high, out);
+	}
+#endif
+	return vector_double_filter_scalar(data, size, low, high, out);
+}
+
+/* The elements of src in the closed interval [low, high] are appended to dst in their original
+ * order. dst and src must be different vectors. src is filtered in chunks of
+ * VECTOR_OPS_FILTER_CHUNK elements and dst only needs room for one chunk beyond the elements
+ * written so far, so dst grows with the result and not with src. dst is returned. NULL is returned
+ * if memory could not be allocated, in which case dst holds the matching elements of a prefix of
+ * src.
+ */
+struct vector_double *vector_double_filter(struct vector_double *dst, const struct vector_double *src, double low, double high)
+{
+	for (size_t i = 0; i < src->size; i += VECTOR_OPS_FILTER_CHUNK) {
+		size_t n = src->size - i < VECTOR_OPS_FILTER_CHUNK ? src->size - i : VECTOR_OPS_FILTER_CHUNK;
+		if (dst->capacity - dst->size < n) {
+			size_t capacity = 2 * dst->capacity;
+			if (capacity < dst->size + n) capacity = dst->size + n;
+			vector_double_set_capacity(dst, capacity);
+			if (dst->capacity - dst->size < n) return NULL;
+		}
+		dst->size += vector_double_filter_chunk(src->data + i, n, low, high, dst->data + dst->size);
+	}
+
+	return dst;
+}
+
+/* t is added to every element of vec. vec is returned. */
+struct vector_double *vector_double_add_scalar(struct vector_double *vec, double t)
+{
+	switch (vector_double_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_double_simd_avx2: vector_double_add_scalar_avx2(vec->data, vec->size, t); break;
+	case vector_double_simd_sse2: vector_double_add_scalar_sse2(vec->data, vec->size, t); break;
+#endif
+	default: vector_double_add_scalar_scalar(vec->data, vec->size, t); break;
+	}
+
+	return vec;
+}
+
+/* Every element of vec is multiplied by t. vec is returned. */
+struct vector_double *vector_double_mul_scalar(struct vector_double *vec, double t)
+{
+	switch (vector_double_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_double_simd_avx2: vector_double_mul_scalar_avx2(vec->data, vec->size, t); break;
+	case vector_double_simd_sse2: vector_double_mul_scalar_sse2(vec->data, vec->size, t); break;
+#endif
+	default: vector_double_mul_scalar_scalar(vec->data, vec->size, t); break;
+	}
+
+	return vec;
+}
@@ -0,0 +1,23 @@
+/* This file is generated by the cgen program, https://github.com/morten-krogh/cgen. The cgen program is released under the MIT license.*/
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "vector_double.h"
+
+enum vector_double_simd {
+	vector_double_simd_scalar,
+	vector_double_simd_sse2,
+	vector_double_simd_avx2
+};
+
+enum vector_double_simd vector_double_simd_level(void);
+enum vector_double_simd vector_double_set_simd_level(enum vector_double_simd level);
+size_t vector_double_find(const struct vector_double *vec, double t);
+size_t vector_double_count(const struct vector_double *vec, double t);
+bool vector_double_min(const struct vector_double *vec, double *min);
+bool vector_double_max(const struct vector_double *vec, double *max);
+double vector_double_sum(const struct vector_double *vec);
+struct vector_double *vector_double_filter(struct vector_double *dst, const struct vector_double *src, double low, double high);
+struct vector_double *vector_double_add_scalar(struct vector_double *vec, double t);
+struct vector_double *vector_double_mul_scalar(struct vector_double *vec, double t);
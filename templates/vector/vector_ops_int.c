@@ -0,0 +1,508 @@
+/* This file is generated by the cgen program, https://github.com/morten-krogh/cgen. The cgen program is released under the MIT license.*/
+
+#include "vector_ops_int.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VECTOR_OPS_SIMD
+#include <immintrin.h>
+#endif
+
+/* Sums, additions and multiplications of integers are done in the unsigned type of the same size
+ * and converted back to int. They wrap around modulo 2^bits instead of overflowing, which is
+ * undefined for signed types. Floating point types are used as they are. Other compilers than gcc
+ * and clang do the arithmetic in int.
+ */
+#ifdef __GNUC__
+typedef __typeof__(__builtin_choose_expr(
+	__builtin_types_compatible_p(int, float) || __builtin_types_compatible_p(int, double), (int) 0,
+	__builtin_choose_expr(sizeof(int) == 1, (uint8_t) 0,
+	__builtin_choose_expr(sizeof(int) == 2, (uint16_t) 0,
+	__builtin_choose_expr(sizeof(int) == 4, (uint32_t) 0, (uint64_t) 0))))) wrap_int;
+#else
+typedef int wrap_int;
+#endif
+
+/* The scalar versions are used on all platforms for the elements that do not fill a whole SIMD
+ * register and as the fallback when no SIMD version is available.
+ */
+
+static size_t vector_int_find_scalar(const int *data, size_t size, int t)
+{
+	for (size_t i = 0; i < size; i++) {
+		if (data[i] == t) return i;
+	}
+	return size;
+}
+
+static size_t vector_int_count_scalar(const int *data, size_t size, int t)
+{
+	size_t count = 0;
+	for (size_t i = 0; i < size; i++) {
+		count += data[i] == t;
+	}
+	return count;
+}
+
+static int vector_int_min_scalar(const int *data, size_t size, int min)
+{
+	for (size_t i = 0; i < size; i++) {
+		if (data[i] < min) min = data[i];
+	}
+	return min;
+}
+
+static int vector_int_max_scalar(const int *data, size_t size, int max)
+{
+	for (size_t i = 0; i < size; i++) {
+		if (data[i] > max) max = data[i];
+	}
+	return max;
+}
+
+static wrap_int vector_int_sum_scalar(const int *data, size_t size)
+{
+	wrap_int sum = 0;
+	for (size_t i = 0; i < size; i++) {
+		sum += (wrap_int) data[i];
+	}
+	return sum;
+}
+
+#define VECTOR_OPS_FILTER_CHUNK 1024
+
+/* The elements in [low, high] are written to out which must have room for size elements. The
+ * number of written elements is returned. Every element is stored and the count is only advanced
+ * for matching elements, which avoids a hard to predict branch.
+ */
+static size_t vector_int_filter_scalar(const int *data, size_t size, int low, int high, int *out)
+{
+	size_t count = 0;
+	for (size_t i = 0; i < size; i++) {
+		out[count] = data[i];
+		count += data[i] >= low && data[i] <= high;
+	}
+	return count;
+}
+
+static void vector_int_add_scalar_scalar(int *data, size_t size, int t)
+{
+	for (size_t i = 0; i < size; i++) {
+		data[i] = (int) (wrap_int) ((wrap_int) data[i] + (wrap_int) t);
+	}
+}
+
+/* The factor 1u keeps 16 bit operands from being promoted to int, where their product can overflow.
+ */
+static void vector_int_mul_scalar_scalar(int *data, size_t size, int t)
+{
+	for (size_t i = 0; i < size; i++) {
+		data[i] = (int) (wrap_int) (1u * (wrap_int) data[i] * (wrap_int) t);
+	}
+}
+
+#ifdef VECTOR_OPS_SIMD
+
+/* The SIMD kernels are written once in the macro below and expanded for 16 byte SSE2 vectors and
+ * 32 byte AVX2 vectors. gcc lowers a vector comparison element by element when the vector is wider
+ * than the target registers, so each instruction set needs its own vector width. Loads and stores
+ * go through memcpy because vec->data is only aligned for int. A comparison of two vectors gives
+ * a mask vector whose lanes are 0 or -1. The helpers are always inlined into the kernels, so the
+ * gcc warning about the AVX calling convention for vectors passed by value does not apply.
+ */
+
+#if !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+typedef int vec_sse2_int __attribute__((vector_size(16)));
+typedef int vec_avx2_int __attribute__((vector_size(32)));
+typedef uint64_t bits_sse2_int __attribute__((vector_size(16)));
+typedef uint64_t bits_avx2_int __attribute__((vector_size(32)));
+typedef __typeof__((vec_sse2_int){0} == (vec_sse2_int){0}) mask_sse2_int;
+typedef __typeof__((vec_avx2_int){0} == (vec_avx2_int){0}) mask_avx2_int;
+
+/* Sums, additions and multiplications are done on lanes of wrap_int like the scalar versions. */
+typedef wrap_int wrap_sse2_int __attribute__((vector_size(16)));
+typedef wrap_int wrap_avx2_int __attribute__((vector_size(32)));
+
+#define VECTOR_OPS_KERNELS(ISA)								\
+											\
+enum { lanes_##ISA##_int = sizeof(vec_##ISA##_int) / sizeof(int) };			\
+											\
+static inline __attribute__((always_inline, target(#ISA)))				\
+vec_##ISA##_int vector_int_load_##ISA(const int *data)				\
+{											\
+	vec_##ISA##_int v;								\
+	memcpy(&v, data, sizeof v);							\
+	return v;									\
+}											\
+											\
+static inline __attribute__((always_inline, target(#ISA)))				\
+vec_##ISA##_int vector_int_splat_##ISA(int t)					\
+{											\
+	vec_##ISA##_int v;								\
+	for (size_t j = 0; j < lanes_##ISA##_int; j++) {				\
+		v[j] = t;								\
+	}										\
+	return v;									\
+}											\
+											\
+static inline __attribute__((always_inline, target(#ISA)))				\
+bool vector_int_any_##ISA(mask_##ISA##_int m)						\
+{											\
+	bits_##ISA##_int b = (bits_##ISA##_int) m;					\
+	uint64_t any = 0;								\
+	for (size_t j = 0; j < sizeof b / sizeof(uint64_t); j++) {			\
+		any |= b[j];								\
+	}										\
+	return any != 0;								\
+}											\
+											\
+/* The lanes of a where m is set and the lanes of b elsewhere */			\
+static inline __attribute__((always_inline, target(#ISA)))				\
+vec_##ISA##_int vector_int_blend_##ISA(vec_##ISA##_int a, vec_##ISA##_int b, mask_##ISA##_int m) \
+{											\
+	return (vec_##ISA##_int) (((mask_##ISA##_int) a & m) | ((mask_##ISA##_int) b & ~m)); \
+}											\
+											\
+static __attribute__((target(#ISA)))							\
+size_t vector_int_find_##ISA(const int *data, size_t size, int t)			\
+{											\
+	vec_##ISA##_int splat = vector_int_splat_##ISA(t);				\
+	size_t i = 0;									\
+	for (; i + lanes_##ISA##_int <= size; i += lanes_##ISA##_int) {		\
+		mask_##ISA##_int m = vector_int_load_##ISA(data + i) == splat;	\
+		if (vector_int_any_##ISA(m)) {						\
+			for (size_t j = 0;; j++) {					\
+				if (m[j]) return i + j;					\
+			}								\
+		}									\
+	}										\
+	return i + vector_int_find_scalar(data + i, size - i, t);			\
+}											\
+											\
+/* The matches are accumulated as -1 lanes in a mask vector. The lanes can be as narrow	\
+ * as 8 bits, so they are added up before they can overflow.				\
+ */											\
+static __attribute__((target(#ISA)))							\
+size_t vector_int_count_##ISA(const int *data, size_t size, int t)			\
+{											\
+	vec_##ISA##_int splat = vector_int_splat_##ISA(t);				\
+	size_t count = 0;								\
+	size_t i = 0;									\
+	while (i + lanes_##ISA##_int <= size) {					\
+		mask_##ISA##_int acc = (mask_##ISA##_int) (bits_##ISA##_int) {0};	\
+		for (int n = 0; n < 127 && i + lanes_##ISA##_int <= size; n++, i += lanes_##ISA##_int) { \
+			acc += vector_int_load_##ISA(data + i) == splat;		\
+		}									\
+		for (size_t j = 0; j < lanes_##ISA##_int; j++) {			\
+			count -= acc[j];						\
+		}									\
+	}										\
+	return count + vector_int_count_scalar(data + i, size - i, t);			\
+}											\
+											\
+/* size must be at least one vector */							\
+static __attribute__((target(#ISA)))							\
+int vector_int_min_##ISA(const int *data, size_t size)				\
+{											\
+	vec_##ISA##_int acc = vector_int_load_##ISA(data);				\
+	size_t i = lanes_##ISA##_int;							\
+	for (; i + lanes_##ISA##_int <= size; i += lanes_##ISA##_int) {		\
+		vec_##ISA##_int v = vector_int_load_##ISA(data + i);			\
+		acc = vector_int_blend_##ISA(v, acc, v < acc);				\
+	}										\
+	int min = vector_int_min_scalar((const int *) &acc, lanes_##ISA##_int, acc[0]); \
+	return vector_int_min_scalar(data + i, size - i, min);				\
+}											\
+											\
+/* size must be at least one vector */							\
+static __attribute__((target(#ISA)))							\
+int vector_int_max_##ISA(const int *data, size_t size)				\
+{											\
+	vec_##ISA##_int acc = vector_int_load_##ISA(data);				\
+	size_t i = lanes_##ISA##_int;							\
+	for (; i + lanes_##ISA##_int <= size; i += lanes_##ISA##_int) {		\
+		vec_##ISA##_int v = vector_int_load_##ISA(data + i);			\
+		acc = vector_int_blend_##ISA(v, acc, v > acc);				\
+	}										\
+	int max = vector_int_max_scalar((const int *) &acc, lanes_##ISA##_int, acc[0]); \
+	return vector_int_max_scalar(data + i, size - i, max);				\
+}											\
+											\
+static __attribute__((target(#ISA)))							\
+int vector_int_sum_##ISA(const int *data, size_t size)				\
+{											\
+	wrap_##ISA##_int acc = (wrap_##ISA##_int) vector_int_splat_##ISA(0);	\
+	size_t i = 0;									\
+	for (; i + lanes_##ISA##_int <= size; i += lanes_##ISA##_int) {		\
+		acc += (wrap_##ISA##_int) vector_int_load_##ISA(data + i);		\
+	}										\
+	wrap_int sum = 0;								\
+	for (size_t j = 0; j < lanes_##ISA##_int; j++) {				\
+		sum += acc[j];								\
+	}										\
+	return (int) (wrap_int) (sum + vector_int_sum_scalar(data + i, size - i));	\
+}											\
+											\
+static __attribute__((target(#ISA)))							\
+void vector_int_add_scalar_##ISA(int *data, size_t size, int t)			\
+{											\
+	wrap_##ISA##_int splat = (wrap_##ISA##_int) vector_int_splat_##ISA(t);	\
+	size_t i = 0;									\
+	for (; i + lanes_##ISA##_int <= size; i += lanes_##ISA##_int) {		\
+		wrap_##ISA##_int v = (wrap_##ISA##_int) vector_int_load_##ISA(data + i) + splat; \
+		memcpy(data + i, &v, sizeof v);						\
+	}										\
+	vector_int_add_scalar_scalar(data + i, size - i, t);				\
+}											\
+											\
+static __attribute__((target(#ISA)))							\
+void vector_int_mul_scalar_##ISA(int *data, size_t size, int t)			\
+{											\
+	wrap_##ISA##_int splat = (wrap_##ISA##_int) vector_int_splat_##ISA(t);	\
+	size_t i = 0;									\
+	for (; i + lanes_##ISA##_int <= size; i += lanes_##ISA##_int) {		\
+		wrap_##ISA##_int v = (wrap_##ISA##_int) vector_int_load_##ISA(data + i) * splat; \
+		memcpy(data + i, &v, sizeof v);						\
+	}										\
+	vector_int_mul_scalar_scalar(data + i, size - i, t);				\
+}
+
+VECTOR_OPS_KERNELS(sse2)
+VECTOR_OPS_KERNELS(avx2)
+
+/* filter on AVX2 for types of 4 and 8 bytes. The lanes of a vector that match are moved to the
+ * front by a permutation of its eight 32 bit units, the whole vector is stored and the count is
+ * advanced by the number of matches. The permutation is looked up by the bit mask of the matching
+ * units. An 8 byte lane covers two units with the same mask bit, which stay together. The table
+ * entry for mask m holds the indices of the set bits of m, one per byte, and is computed by the
+ * macros below.
+ */
+#define VECTOR_OPS_BITS(m) (((m) & 1) + ((m) >> 1 & 1) + ((m) >> 2 & 1) + ((m) >> 3 & 1) + \
+	((m) >> 4 & 1) + ((m) >> 5 & 1) + ((m) >> 6 & 1) + ((m) >> 7 & 1))
+#define VECTOR_OPS_INDEX(m, j) (((uint64_t) ((m) >> (j) & 1) * (j)) << (8 * VECTOR_OPS_BITS((m) & ((1 << (j)) - 1))))
+#define VECTOR_OPS_COMPRESS(m) (VECTOR_OPS_INDEX(m, 0) | VECTOR_OPS_INDEX(m, 1) | VECTOR_OPS_INDEX(m, 2) | \
+	VECTOR_OPS_INDEX(m, 3) | VECTOR_OPS_INDEX(m, 4) | VECTOR_OPS_INDEX(m, 5) | VECTOR_OPS_INDEX(m, 6) | \
+	VECTOR_OPS_INDEX(m, 7))
+#define VECTOR_OPS_COMPRESS4(m) VECTOR_OPS_COMPRESS(m), VECTOR_OPS_COMPRESS((m) + 1), \
+	VECTOR_OPS_COMPRESS((m) + 2), VECTOR_OPS_COMPRESS((m) + 3)
+#define VECTOR_OPS_COMPRESS16(m) VECTOR_OPS_COMPRESS4(m), VECTOR_OPS_COMPRESS4((m) + 4), \
+	VECTOR_OPS_COMPRESS4((m) + 8), VECTOR_OPS_COMPRESS4((m) + 12)
+#define VECTOR_OPS_COMPRESS64(m) VECTOR_OPS_COMPRESS16(m), VECTOR_OPS_COMPRESS16((m) + 16), \
+	VECTOR_OPS_COMPRESS16((m) + 32), VECTOR_OPS_COMPRESS16((m) + 48)
+
+static const uint64_t vector_int_compress[256] = {
+	VECTOR_OPS_COMPRESS64(0), VECTOR_OPS_COMPRESS64(64), VECTOR_OPS_COMPRESS64(128), VECTOR_OPS_COMPRESS64(192)
+};
+
+/* Like vector_int_filter_scalar. The whole vector is stored, and the count only ever trails i, so
+ * out has room for it.
+ */
+static __attribute__((target("avx2")))
+size_t vector_int_filter_avx2(const int *data, size_t size, int low, int high, int *out)
+{
+	vec_avx2_int l = vector_int_splat_avx2(low);
+	vec_avx2_int h = vector_int_splat_avx2(high);
+	size_t count = 0;
+	size_t i = 0;
+	for (; i + lanes_avx2_int <= size; i += lanes_avx2_int) {
+		vec_avx2_int v = vector_int_load_avx2(data + i);
+		mask_avx2_int m = (v >= l) & (v <= h);
+		int bits = _mm256_movemask_ps((__m256) m);
+		__m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (vector_int_compress + bits)));
+		_mm256_storeu_si256((__m256i *) (out + count), _mm256_permutevar8x32_epi32((__m256i) v, index));
+		count += (size_t) __builtin_popcount(bits) * 4 / sizeof(int);
+	}
+	return count + vector_int_filter_scalar(data + i, size - i, low, high, out + count);
+}
+
+#endif
+
+/* The level used by the operations. It is only written by vector_int_set_simd_level. */
+static enum vector_int_simd vector_int_level = vector_int_simd_scalar;
+
+/* The level is used for all subsequent operations. The return value is the level actually used
+ * which is lower than the argument if the compiler or cpu does not support the argument. The level
+ * is not synchronized with operations running in other threads. Before main is entered it is set to
+ * the best supported level.
+ */
+enum vector_int_simd vector_int_set_simd_level(enum vector_int_simd level)
+{
+	enum vector_int_simd supported = vector_int_simd_scalar;
+#ifdef VECTOR_OPS_SIMD
+	if (__builtin_cpu_supports("avx2")) supported = vector_int_simd_avx2;
+	else if (__builtin_cpu_supports("sse2")) supported = vector_int_simd_sse2;
+#endif
+	vector_int_level = level < supported ? level : supported;
+	return vector_int_level;
+}
+
+enum vector_int_simd vector_int_simd_level(void)
+{
+	return vector_int_level;
+}
+
+#ifdef VECTOR_OPS_SIMD
+/* Constructors can run before the cpu model used by __builtin_cpu_supports is initialized, so it is
+ * initialized here first.
+ */
+static __attribute__((constructor)) void vector_int_init_simd_level(void)
+{
+	__builtin_cpu_init();
+	vector_int_set_simd_level(vector_int_simd_avx2);
+}
+#endif
+
+/* The index of the first element equal to t is returned. vec->size is returned if there is none.
+ */
+size_t vector_int_find(const struct vector_int *vec, int t)
+{
+	switch (vector_int_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_int_simd_avx2: return vector_int_find_avx2(vec->data, vec->size, t);
+	case vector_int_simd_sse2: return vector_int_find_sse2(vec->data, vec->size, t);
+#endif
+	default: return vector_int_find_scalar(vec->data, vec->size, t);
+	}
+}
+
+size_t vector_int_count(const struct vector_int *vec, int t)
+{
+	switch (vector_int_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_int_simd_avx2: return vector_int_count_avx2(vec->data, vec->size, t);
+	case vector_int_simd_sse2: return vector_int_count_sse2(vec->data, vec->size, t);
+#endif
+	default: return vector_int_count_scalar(vec->data, vec->size, t);
+	}
+}
+
+/* The smallest element is written to min. The bool return value is false if the vector is empty
+ * in which case min is untouched.
+ */
+bool vector_int_min(const struct vector_int *vec, int *min)
+{
+	if (vec->size == 0) return false;
+	switch (vector_int_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_int_simd_avx2:
+		if (vec->size < lanes_avx2_int) break;
+		*min = vector_int_min_avx2(vec->data, vec->size);
+		return true;
+	case vector_int_simd_sse2:
+		if (vec->size < lanes_sse2_int) break;
+		*min = vector_int_min_sse2(vec->data, vec->size);
+		return true;
+#endif
+	default:
+		break;
+	}
+	*min = vector_int_min_scalar(vec->data, vec->size, vec->data[0]);
+	return true;
+}
+
+/* The largest element is written to max. The bool return value is false if the vector is empty
+ * in which case max is untouched.
+ */
+bool vector_int_max(const struct vector_int *vec, int *max)
+{
+	if (vec->size == 0) return false;
+	switch (vector_int_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_int_simd_avx2:
+		if (vec->size < lanes_avx2_int) break;
+		*max = vector_int_max_avx2(vec->data, vec->size);
+		return true;
+	case vector_int_simd_sse2:
+		if (vec->size < lanes_sse2_int) break;
+		*max = vector_int_max_sse2(vec->data, vec->size);
+		return true;
+#endif
+	default:
+		break;
+	}
+	*max = vector_int_max_scalar(vec->data, vec->size, vec->data[0]);
+	return true;
+}
+
+/* The sum is accumulated in int. Integer sums wrap around modulo 2^bits of int on overflow.
+ * add_scalar and mul_scalar wrap around in the same way.
+ */
+int vector_int_sum(const struct vector_int *vec)
+{
+	switch (vector_int_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_int_simd_avx2: return vector_int_sum_avx2(vec->data, vec->size);
+	case vector_int_simd_sse2: return vector_int_sum_sse2(vec->data, vec->size);
+#endif
+	default: return (int) vector_int_sum_scalar(vec->data, vec->size);
+	}
+}
+
+/* There is no permutation of 1 and 2 byte lanes in AVX2 and none at all in SSE2, so those filter
+ * with the scalar version.
+ */
+static size_t vector_int_filter_chunk(const int *data, size_t size, int low, int high, int *out)
+{
+#ifdef VECTOR_OPS_SIMD
+	if (vector_int_simd_level() == vector_int_simd_avx2 && sizeof(int) >= 4) {
+		return vector_int_filter_avx2(data, size, low, high, out);
+	}
+#endif
+	return vector_int_filter_scalar(data, size, low, high, out);
+}
+
+/* The elements of src in the closed interval [low, high] are appended to dst in their original
+ * order. dst and src must be different vectors. src is filtered in chunks of
+ * VECTOR_OPS_FILTER_CHUNK elements and dst only needs room for one chunk beyond the elements
+ * written so far, so dst grows with the result and not with src. dst is returned. NULL is returned
+ * if memory could not be allocated, in which case dst holds the matching elements of a prefix of
+ * src.
+ */
+struct vector_int *vector_int_filter(struct vector_int *dst, const struct vector_int *src, int low, int high)
+{
+	for (size_t i = 0; i < src->size; i += VECTOR_OPS_FILTER_CHUNK) {
+		size_t n = src->size - i < VECTOR_OPS_FILTER_CHUNK ? src->size - i : VECTOR_OPS_FILTER_CHUNK;
+		if (dst->capacity - dst->size < n) {
+			size_t capacity = 2 * dst->capacity;
+			if (capacity < dst->size + n) capacity = dst->size + n;
+			vector_int_set_capacity(dst, capacity);
+			if (dst->capacity - dst->size < n) return NULL;
+		}
+		dst->size += vector_int_filter_chunk(src->data + i, n, low, high, dst->data + dst->size);
+	}
+
+	return dst;
+}
+
+/* t is added to every element of vec. vec is returned. */
+struct vector_int *vector_int_add_scalar(struct vector_int *vec, int t)
+{
+	switch (vector_int_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_int_simd_avx2: vector_int_add_scalar_avx2(vec->data, vec->size, t); break;
+	case vector_int_simd_sse2: vector_int_add_scalar_sse2(vec->data, vec->size, t); break;
+#endif
+	default: vector_int_add_scalar_scalar(vec->data, vec->size, t); break;
+	}
+
+	return vec;
+}
+
+/* Every element of vec is multiplied by t. vec is returned. */
+struct vector_int *vector_int_mul_scalar(struct vector_int *vec, int t)
+{
+	switch (vector_int_simd_level()) {
+#ifdef VECTOR_OPS_SIMD
+	case vector_int_simd_avx2: vector_int_mul_scalar_avx2(vec->data, vec->size, t); break;
+	case vector_int_simd_sse2: vector_int_mul_scalar_sse2(vec->data, vec->size, t); break;
+#endif
+	default: vector_int_mul_scalar_scalar(vec->data, vec->size, t); break;
+	}
+
+	return vec;
+}
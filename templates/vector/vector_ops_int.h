@@ -0,0 +1,23 @@
+/* This file is generated by the cgen program, https://github.com/morten-krogh/cgen. The cgen program is released under the MIT license.*/
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "vector_int.h"
+
+enum vector_int_simd {
+	vector_int_simd_scalar,
+	vector_int_simd_sse2,
+	vector_int_simd_avx2
+};
+
+enum vector_int_simd vector_int_simd_level(void);
+enum vector_int_simd vector_int_set_simd_level(enum vector_int_simd level);
+size_t vector_int_find(const struct vector_int *vec, int t);
+size_t vector_int_count(const struct vector_int *vec, int t);
+bool vector_int_min(const struct vector_int *vec, int *min);
+bool vector_int_max(const struct vector_int *vec, int *max);
+int vector_int_sum(const struct vector_int *vec);
+struct vector_int *vector_int_filter(struct vector_int *dst, const struct vector_int *src, int low, int high);
+struct vector_int *vector_int_add_scalar(struct vector_int *vec, int t);
+struct vector_int *vector_int_mul_scalar(struct vector_int *vec, int t);